@@ -0,0 +1,580 @@
+// Benchmarks: One Executable for the Project Subsystems
+// 🔹 Concept: Time the hot paths of the projects in this folder with one harness (repetitions, warmup,
+//    CPU pinning) and save the results as JSON, so two commits can be compared and regressions caught.
+// 🔹 Covered: TaskQueue push/pop, compressChunk, BankAccount::deposit under contention, Logger::log,
+//    TaskManager::sortTasks and metadata lookups (std::any map vs. CompactMetadata).
+// 🔹 Each project stays a single-file program: it is compiled into its own namespace here, with its main renamed.
+
+// 📌 Build (the benchmarks target of the Makefile next to the projects):
+//    make benchmarks
+//    (same as g++ -std=c++17 -O2 -pthread Benchmarks.cpp -o benchmarks -lz)
+// 📌 Usage:
+//    ./benchmarks [--reps N] [--warmup N] [--cpus LIST] [--filter TEXT] [--json FILE]
+//                 [--compare BASELINE.json] [--threshold PERCENT]
+//    --cpus 0 or --cpus 0,2-3 pins the process (threads started later inherit it).
+//    --compare exits with status 1 when a benchmark is more than --threshold percent (default 10) slower.
+// 📌 Comparing two commits:
+//    git checkout A && make benchmarks && ./benchmarks --json a.json
+//    git checkout B && make benchmarks && ./benchmarks --compare a.json
+
+
+// 📌 Step 1: Pull in the Projects
+// Every header the projects use is included here first, at global scope: their own #include lines
+// inside the namespaces below then expand to nothing.
+// ⚠️ Requirement: when a project included below starts using a new header, add it to this list too.
+//    Otherwise that header is first included inside the project's namespace, where it declares its
+//    std:: (or C library) names as e.g. metadata::std::, and the build fails with errors far from the cause.
+
+// 🖥️ Code: Project Sources
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <queue>
+#include <deque>
+#include <set>
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <any>
+#include <optional>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <type_traits>
+#include <typeinfo>
+#include <stdexcept>
+#include <system_error>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <zlib.h>
+#include <malloc.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "FastOutput.h"
+
+#define main taskQueueMain
+namespace taskqueue {
+#include "High-PerformanceMultiThreadedTaskQueue.cpp"
+}
+#undef main
+
+#define main compressionMain
+namespace compression {
+#include "Multi-ThreadedFileCompression .cpp"
+}
+#undef main
+
+#define main bankingMain
+namespace banking {
+#include "ThreadSafeBankingSystem.cpp"
+}
+#undef main
+
+#define main loggingMain
+namespace logging {
+#include "EfficientMemoryLoggingSystem.cpp"
+}
+#undef main
+
+#define main sortingMain
+namespace sorting {
+#include "Multi-AttributeTaskSorting.cpp"
+}
+#undef main
+
+#define main metadataMain
+namespace metadata {
+#include "FlexibleTaskMetadataManager.cpp"
+}
+#undef main
+
+
+// 📌 Step 2: Benchmark Harness
+// run() calls prepare() once per repetition (warmups included). prepare does the untimed setup and returns
+// the body, and only the body is timed. Results are reported per item (an operation, a byte, a task),
+// so runs with different sizes still compare.
+
+// 🖥️ Code: Harness
+
+struct BenchmarkOptions {
+    int reps = 10;
+    int warmup = 2;
+    std::string cpus;          // "" leaves the affinity alone
+    std::string filter;        // run only benchmarks whose name contains it
+    std::string jsonPath;
+    std::string comparePath;
+    double thresholdPercent = 10;
+};
+
+struct BenchmarkResult {
+    std::string name;
+    std::string unit;              // what one item is: "op", "B", "task"
+    double itemsPerRep;
+    std::vector<double> seconds;   // one per measured repetition, sorted once run() is done
+
+    double min() const { return seconds.front(); }
+    double median() const {
+        size_t n = seconds.size();
+        return n % 2 ? seconds[n / 2] : (seconds[n / 2 - 1] + seconds[n / 2]) / 2;
+    }
+    double mean() const {
+        return std::accumulate(seconds.begin(), seconds.end(), 0.0) / seconds.size();
+    }
+    double stddev() const {
+        double m = mean(), sum = 0;
+        for (double s : seconds) sum += (s - m) * (s - m);
+        return seconds.size() > 1 ? std::sqrt(sum / (seconds.size() - 1)) : 0;
+    }
+    double nsPerItem() const { return median() * 1e9 / itemsPerRep; }
+};
+
+// Keeps results the optimizer could otherwise prove unused
+volatile int64_t benchmarkSink;
+
+class BenchmarkRunner {
+    private:
+        BenchmarkOptions options;
+        std::vector<BenchmarkResult> completed;
+
+    public:
+        explicit BenchmarkRunner(BenchmarkOptions opts) : options(std::move(opts)) {}
+
+        template <typename Prepare>
+        void run(const std::string& name, const std::string& unit, double itemsPerRep, Prepare prepare) {
+            if (name.find(options.filter) == std::string::npos) return;
+            BenchmarkResult result{name, unit, itemsPerRep, {}};
+            for (int rep = 0; rep < options.warmup + options.reps; ++rep) {
+                auto body = prepare();
+                auto start = std::chrono::steady_clock::now();
+                body();
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (rep >= options.warmup) result.seconds.push_back(seconds);
+            }
+            std::sort(result.seconds.begin(), result.seconds.end());
+
+            // Per item: ns/op and Mop/s, ns/B and MB/s, ...
+            char line[200];
+            std::snprintf(line, sizeof(line), "%-32s %10.2f ns/%-4s %9.2f M%s/s   (min %.4g s, mean %.4g s +- %.2g)",
+                          name.c_str(), result.nsPerItem(), unit.c_str(), 1e3 / result.nsPerItem(), unit.c_str(),
+                          result.min(), result.mean(), result.stddev());
+            std::cout << line << std::endl;
+            completed.push_back(std::move(result));
+        }
+
+        const std::vector<BenchmarkResult>& results() const {
+            return completed;
+        }
+};
+
+// Redirects stdout to /dev/null while alive, for code that prints on every call (BankAccount::deposit)
+class SilenceStdout {
+    private:
+        int console;
+
+    public:
+        SilenceStdout() {
+            std::cout.flush();
+            console = dup(STDOUT_FILENO);
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+        ~SilenceStdout() {
+            std::cout.flush();
+            dup2(console, STDOUT_FILENO);
+            close(console);
+        }
+        SilenceStdout(const SilenceStdout&) = delete;
+        SilenceStdout& operator=(const SilenceStdout&) = delete;
+};
+
+// "0,2-3" -> CPUs 0, 2 and 3 for this process and every thread it starts afterwards
+void pinToCpus(const std::string& list) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::stringstream items(list);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        size_t dash = item.find('-');
+        try {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            if (first < 0 || last < first || last >= CPU_SETSIZE) throw std::out_of_range(item);
+            for (int cpu = first; cpu <= last; ++cpu) CPU_SET(cpu, &set);
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("Bad CPU list: " + list);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        throw std::system_error(errno, std::generic_category(), "sched_setaffinity(" + list + ")");
+    }
+}
+
+
+// 📌 Step 3: Microbenchmarks
+// Sizes are fixed, so the same benchmark names always measure the same work.
+
+// 🖥️ Code: TaskQueue push/pop
+// Uncontended: one thread pushes a batch, then pops it. Workers: the main thread pushes while
+// worker threads pop and run the tasks, as in the project's main (without its per-task printing).
+
+void benchmarkTaskQueue(BenchmarkRunner& runner) {
+    const size_t numTasks = 200000;
+    runner.run("taskqueue/push_pop", "task", numTasks, [&] {
+        auto queue = std::make_shared<taskqueue::TaskQueue>();
+        return [queue, numTasks] {
+            int64_t ran = 0;
+            for (size_t i = 0; i < numTasks; ++i) queue->pushTask([&ran] { ++ran; });
+            for (size_t i = 0; i < numTasks; ++i) queue->popTask()();
+            benchmarkSink = ran;
+        };
+    });
+
+    for (int numWorkers : {1, 4}) {
+        runner.run("taskqueue/workers=" + std::to_string(numWorkers), "task", numTasks, [&] {
+            struct State {
+                taskqueue::TaskQueue queue;
+                std::atomic<int64_t> ran{0};
+                std::vector<std::thread> workers;
+            };
+            auto state = std::make_shared<State>();
+            for (int i = 0; i < numWorkers; ++i) {
+                state->workers.emplace_back([queue = &state->queue] {
+                    while (auto task = queue->popTask()) task();
+                });
+            }
+            return [state, numTasks] {
+                for (size_t i = 0; i < numTasks; ++i) {
+                    state->queue.pushTask([ran = &state->ran] { ran->fetch_add(1, std::memory_order_relaxed); });
+                }
+                state->queue.shutdown();  // Workers drain the queue before they stop
+                for (auto& worker : state->workers) worker.join();
+                if (state->ran != static_cast<int64_t>(numTasks)) throw std::logic_error("TaskQueue lost tasks");
+            };
+        });
+    }
+}
+
+// 🖥️ Code: compressChunk throughput
+// A 1 MB chunk (the project's chunk size) of log-like text: repetitive, but not trivially so.
+
+void benchmarkCompression(BenchmarkRunner& runner) {
+    const size_t chunkSize = 1024 * 1024;
+    std::vector<char> chunk;
+    chunk.reserve(chunkSize + 128);
+    std::mt19937 rng(42);
+    const char* levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+    while (chunk.size() < chunkSize) {
+        char line[128];
+        int length = std::snprintf(line, sizeof(line), "2025-03-%02u 12:%02u:%02u %s worker %u processed request %u in %u ms\n",
+                                   unsigned(rng() % 28 + 1), unsigned(rng() % 60), unsigned(rng() % 60), levels[rng() % 4],
+                                   unsigned(rng() % 8), unsigned(rng() % 1000000), unsigned(rng() % 500));
+        chunk.insert(chunk.end(), line, line + length);
+    }
+    chunk.resize(chunkSize);
+
+    runner.run("compress/chunk_1MB", "B", chunkSize, [&chunk] {
+        return [&chunk] { benchmarkSink = compression::compressChunk(chunk).size(); };
+    });
+}
+
+// 🖥️ Code: BankAccount deposit contention
+// Every thread deposits into the same account. deposit prints each new balance, so stdout goes to
+// /dev/null while timing: the printing is part of what deposit costs, and it runs under the lock.
+
+void benchmarkBanking(BenchmarkRunner& runner) {
+    const size_t depositsPerRep = 200000;
+    for (int numThreads : {1, 2, 4, 8}) {
+        runner.run("bank/deposit/threads=" + std::to_string(numThreads), "op", depositsPerRep, [&] {
+            auto account = std::make_shared<banking::BankAccount>(0);
+            return [account, numThreads, depositsPerRep] {
+                SilenceStdout silence;
+                std::vector<std::thread> customers;
+                for (int t = 0; t < numThreads; ++t) {
+                    customers.emplace_back([&account, numThreads, depositsPerRep] {
+                        for (size_t i = 0; i < depositsPerRep / numThreads; ++i) account->deposit(1);
+                    });
+                }
+                for (auto& customer : customers) customer.join();
+                benchmarkSink = account->getBalance();
+            };
+        });
+    }
+}
+
+// 🖥️ Code: Logger::log latency
+// Messages are built once; each repetition logs them into a fresh Logger, so the vector grows from empty.
+
+void benchmarkLogger(BenchmarkRunner& runner) {
+    const size_t numMessages = 200000;
+    std::vector<std::string> messages;
+    messages.reserve(numMessages);
+    for (size_t i = 0; i < numMessages; ++i) {
+        messages.push_back("Memory allocation of " + std::to_string(i % 512 + 1) + " MB successful.");
+    }
+
+    runner.run("logger/log", "op", numMessages, [&messages] {
+        auto logger = std::make_shared<logging::Logger>();
+        return [logger, &messages] {
+            for (const auto& message : messages) logger->log(message);
+            benchmarkSink = logger->entries().size();
+        };
+    });
+}
+
+// 🖥️ Code: TaskManager::sortTasks
+// Random tasks (the project's own generator, fixed seed). Each repetition sorts a fresh copy, since
+// sorting an already sorted display order would measure something else.
+
+void benchmarkSorting(BenchmarkRunner& runner) {
+    const size_t numTasks = 200000;
+    std::unique_ptr<sorting::TaskManager> unsorted;  // Built by the first benchmark that runs
+    auto freshCopy = [&] {
+        if (!unsorted) {
+            unsorted = std::make_unique<sorting::TaskManager>();
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<int> level(1, 10);
+            for (size_t i = 0; i < numTasks; ++i) {
+                unsorted->addTask(sorting::Task("Task " + std::to_string(i), level(rng), sorting::randomDeadline(rng), level(rng)));
+            }
+        }
+        return std::make_shared<sorting::TaskManager>(*unsorted);
+    };
+
+    runner.run("sort/sortTasks", "task", numTasks, [&] {
+        auto manager = freshCopy();
+        return [manager] { manager->sortTasks(); };
+    });
+    runner.run("sort/sortTasksRadix", "task", numTasks, [&] {
+        auto manager = freshCopy();
+        return [manager] { manager->sortTasksRadix(); };
+    });
+}
+
+// 🖥️ Code: Metadata lookups
+// The std::any lookup is the original representation, unordered_map<string, any> (kept in the project
+// as MapTask); Task now stores CompactMetadata. Both hold the same five fields per task.
+
+void benchmarkMetadata(BenchmarkRunner& runner) {
+    const size_t numTasks = 100000, numLookups = 1000000;
+    const char* assignees[] = {"John Doe", "Jane Smith", "Alexandria Montgomery-Whitfield", "Li Wei"};
+    std::mt19937 rng(42);
+    std::vector<size_t> probes(numLookups);
+    for (auto& probe : probes) probe = rng() % numTasks;
+
+    std::vector<metadata::MapTask> mapTasks;
+    std::vector<metadata::Task> tasks;
+    auto build = [&] {
+        if (!tasks.empty()) return;
+        mapTasks.resize(numTasks);
+        tasks.resize(numTasks);
+        for (size_t i = 0; i < numTasks; ++i) {
+            metadata::MapTask& mapTask = mapTasks[i];
+            mapTask.title = "Task " + std::to_string(i);
+            mapTask.metadata["Priority"] = static_cast<int>(i % 10);
+            mapTask.metadata["Deadline"] = std::string("2025-03-15");
+            mapTask.metadata["Estimated Time"] = 12.5;
+            mapTask.metadata["Assigned To"] = std::string(assignees[i % 4]);
+            mapTask.metadata["Created"] = static_cast<int64_t>(1700000000 + i);
+
+            metadata::Task& task = tasks[i];
+            task.title = mapTask.title;
+            task.addMetadata("Priority", static_cast<int>(i % 10));
+            task.addMetadata("Deadline", std::string("2025-03-15"));
+            task.addMetadata("Estimated Time", 12.5);
+            task.addMetadata("Assigned To", std::string(assignees[i % 4]));
+            task.addMetadata("Created", metadata::Timestamp{static_cast<int64_t>(1700000000 + i)});
+        }
+    };
+
+    runner.run("metadata/any_map_lookup", "op", numLookups, [&] {
+        build();
+        return [&] {
+            int64_t checksum = 0;
+            for (size_t probe : probes) checksum += std::any_cast<int>(mapTasks[probe].metadata.at("Priority"));
+            benchmarkSink = checksum;
+        };
+    });
+    runner.run("metadata/getMetadata_by_name", "op", numLookups, [&] {
+        build();
+        return [&] {
+            int64_t checksum = 0;
+            for (size_t probe : probes) checksum += tasks[probe].getMetadata<int>("Priority");
+            benchmarkSink = checksum;
+        };
+    });
+    runner.run("metadata/tryGet_by_key", "op", numLookups, [&] {
+        build();
+        return [&] {
+            metadata::MetadataKey priority = metadata::MetadataKeyRegistry::global().intern("Priority");
+            int64_t checksum = 0;
+            for (size_t probe : probes) checksum += tasks[probe].tryGet<int>(priority).value_or(0);
+            benchmarkSink = checksum;
+        };
+    });
+}
+
+
+// 📌 Step 4: JSON Results and Regression Check
+// One benchmark object per line, so a baseline file can be read back line by line without a JSON parser.
+// Compared figure: median ns per item. Noise: run both sides on the same machine, pinned, with enough --reps.
+
+// 🖥️ Code: JSON Output
+
+void writeJson(const std::string& path, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), "open " + path);
+
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    {
+        OutputBuffer out(fd);
+        out << "{\n  \"context\": {\"date\":\"" << date << "\",\"compiler\":";
+        out.jsonString(__VERSION__) << ",\"reps\":" << options.reps << ",\"warmup\":" << options.warmup << ",\"cpus\":";
+        out.jsonString(options.cpus) << ",\"hardware_concurrency\":" << std::thread::hardware_concurrency() << "},\n";
+        out << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& result = results[i];
+            out << "    {\"name\":";
+            out.jsonString(result.name) << ",\"unit\":";
+            out.jsonString(result.unit) << ",\"items\":" << static_cast<uint64_t>(result.itemsPerRep) << ",\"reps\":" << result.seconds.size()
+                << ",\"min_s\":" << result.min() << ",\"median_s\":" << result.median() << ",\"mean_s\":" << result.mean()
+                << ",\"stddev_s\":" << result.stddev() << ",\"ns_per_item\":" << result.nsPerItem() << '}'
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        out.flush();
+    }
+    close(fd);
+}
+
+// name -> ns_per_item, from a file written by writeJson
+std::unordered_map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open baseline " + path);
+    std::unordered_map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("{\"name\":\"");
+        size_t nsPerItem = line.find("\"ns_per_item\":");
+        if (name == std::string::npos || nsPerItem == std::string::npos) continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::strtod(line.c_str() + nsPerItem + 14, nullptr);
+    }
+    return baseline;
+}
+
+// Prints the change for every benchmark in both runs; returns the number slower than the threshold
+int compareWithBaseline(const std::string& path, double thresholdPercent, const std::vector<BenchmarkResult>& results) {
+    std::unordered_map<std::string, double> baseline = readBaseline(path);
+    int regressions = 0;
+    std::cout << "\nCompared with " << path << " (median ns/item, threshold " << thresholdPercent << "%):\n";
+    for (const BenchmarkResult& result : results) {
+        auto before = baseline.find(result.name);
+        if (before == baseline.end() || before->second <= 0) {
+            std::cout << "  " << result.name << ": not in baseline\n";
+            continue;
+        }
+        double change = (result.nsPerItem() / before->second - 1) * 100;
+        bool regressed = change > thresholdPercent;
+        regressions += regressed;
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-32s %10.2f -> %10.2f ns  %+7.1f%%%s", result.name.c_str(), before->second,
+                      result.nsPerItem(), change, regressed ? "  REGRESSION" : "");
+        std::cout << line << "\n";
+    }
+    return regressions;
+}
+
+
+// 📌 Step 5: Main Function
+
+// 🖥️ Code: Main
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--help") {
+                std::cout << "Usage: " << argv[0] << " [--reps N] [--warmup N] [--cpus LIST] [--filter TEXT]"
+                          << " [--json FILE] [--compare BASELINE.json] [--threshold PERCENT]\n";
+                return 0;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            std::string value = argv[++i];
+            if (arg == "--reps") options.reps = std::stoi(value);
+            else if (arg == "--warmup") options.warmup = std::stoi(value);
+            else if (arg == "--cpus") options.cpus = value;
+            else if (arg == "--filter") options.filter = value;
+            else if (arg == "--json") options.jsonPath = value;
+            else if (arg == "--compare") options.comparePath = value;
+            else if (arg == "--threshold") options.thresholdPercent = std::stod(value);
+            else throw std::invalid_argument("Unknown option " + arg);
+        }
+        if (options.reps < 1 || options.warmup < 0) throw std::invalid_argument("--reps must be >= 1, --warmup >= 0");
+    } catch (const std::logic_error& e) {
+        std::cerr << "Error: " << e.what() << " (see --help)\n";
+        return 2;
+    }
+
+    try {
+        if (!options.cpus.empty()) pinToCpus(options.cpus);
+        std::cout << "Benchmarks: " << options.reps << " reps after " << options.warmup << " warmup, CPUs "
+                  << (options.cpus.empty() ? "any" : options.cpus) << "\n";
+
+        BenchmarkRunner runner(options);
+        benchmarkTaskQueue(runner);
+        benchmarkCompression(runner);
+        benchmarkBanking(runner);
+        benchmarkLogger(runner);
+        benchmarkSorting(runner);
+        benchmarkMetadata(runner);
+
+        if (!options.jsonPath.empty()) writeJson(options.jsonPath, options, runner.results());
+        if (!options.comparePath.empty()) {
+            int regressions = compareWithBaseline(options.comparePath, options.thresholdPercent, runner.results());
+            if (regressions > 0) {
+                std::cout << regressions << " benchmark(s) regressed\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
+
+
+// 📌 Step 6: Expected Output (format; the numbers depend on the machine)
+// Benchmarks: 10 reps after 2 warmup, CPUs 0
+// taskqueue/push_pop                   ...  ns/task      ... Mtask/s   (min ... s, mean ... s +- ...)
+// compress/chunk_1MB                   ...  ns/B         ... MB/s      (min ... s, mean ... s +- ...)
+// ...
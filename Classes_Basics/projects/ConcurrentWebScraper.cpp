@@ -21,8 +21,40 @@
 #include <future>
 #include <vector>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <cstdio>
+#include <deque>
+#include <unordered_map>
+#include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <fstream>
+#include <mutex>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <optional>
+#include <csignal>
+#include <cerrno>
 #include <curl/curl.h>
 
+// POSIX sockets for the local stand-in server used by the benchmark
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 // Callback function to store fetched data
 size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* output) {
     size_t totalSize = size * nmemb;
@@ -78,12 +110,1618 @@ void scrapeWebsites(const std::vector<std::string>& urls) {
 
 
 
-// 📌 Step 4: Main Function to Run the Scraper
+// 📌 Step 4: Reuse Connections with a Handle Pool and a Shared Cache
+// fetchURL creates and destroys a CURL handle per request, so every fetch pays for DNS, TCP (and TLS) setup
+// and then throws the connection away.
+// ✅ CurlShare: one DNS cache and TLS session cache shared by every handle (curl share interface).
+// ✅ EasyHandlePool: finished handles go back to the pool instead of being cleaned up.
+// ✅ A reused handle keeps its HTTP/1.1 keep-alive connection open for the next request to the same host.
+// ✅ The multiplexed fetcher (Step 7) keeps one handle per slot, so each event loop reuses its connections too.
+
+// 🖥️ Code: Shared Cache and Handle Pool
+
+class CurlShare {
+    private:
+        CURLSH* share;
+        std::mutex locks[CURL_LOCK_DATA_LAST]; // One lock per kind of shared data
+
+        static void lock(CURL*, curl_lock_data data, curl_lock_access, void* self) {
+            static_cast<CurlShare*>(self)->locks[data].lock();
+        }
+
+        static void unlock(CURL*, curl_lock_data data, void* self) {
+            static_cast<CurlShare*>(self)->locks[data].unlock();
+        }
+
+    public:
+        CurlShare() : share(curl_share_init()) {
+            curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock);
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock);
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            // CURL_LOCK_DATA_CONNECT is left out on purpose: cURL does not support sharing one
+            // connection cache between concurrent threads. Connections are kept per handle instead.
+        }
+
+        ~CurlShare() {
+            curl_share_cleanup(share);
+        }
+
+        CurlShare(const CurlShare&) = delete;
+        CurlShare& operator=(const CurlShare&) = delete;
+
+        CURLSH* get() const { return share; }
+    };
+
+
+class EasyHandlePool {
+    private:
+        CurlShare& share;
+        std::mutex mtx;
+        std::vector<CURL*> idle;
+
+    public:
+        explicit EasyHandlePool(CurlShare& s) : share(s) {}
+
+        ~EasyHandlePool() {
+            for (CURL* easy : idle) curl_easy_cleanup(easy);
+        }
+
+        EasyHandlePool(const EasyHandlePool&) = delete;
+        EasyHandlePool& operator=(const EasyHandlePool&) = delete;
+
+        // Returns an idle handle, or a new one with the options every fetch needs
+        CURL* acquire() {
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (!idle.empty()) {
+                    CURL* easy = idle.back();
+                    idle.pop_back();
+                    return easy;
+                }
+            }
+
+            CURL* easy = curl_easy_init();
+            curl_easy_setopt(easy, CURLOPT_SHARE, share.get());
+            curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+            curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L); // Keep idle pooled connections alive
+            return easy;
+        }
+
+        void release(CURL* easy) {
+            std::lock_guard<std::mutex> lock(mtx);
+            idle.push_back(easy);
+        }
+    };
+
+
+// Same as fetchURL, but borrows a pooled handle so the connection survives for the next request
+std::string fetchURLPooled(EasyHandlePool& pool, const std::string& url) {
+    std::string htmlData;
+
+    CURL* curl = pool.acquire();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &htmlData);
+
+    CURLcode res = curl_easy_perform(curl);
+    if (res != CURLE_OK) {
+        std::cerr << "cURL Error: " << curl_easy_strerror(res) << "\n";
+    }
+    pool.release(curl);
+
+    return htmlData;
+}
+
+
+
+// 📌 Step 5: Stream Pages Through Sinks Instead of Buffering Them
+// WriteCallback appends every byte to a std::string, so a 50 MB page costs 50 MB of memory before we look at it.
+// A PageSink receives the bytes as they arrive, chunk by chunk, and decides what to keep:
+// ✅ ByteCountSink: only counts bytes.
+// ✅ FileSink: writes the page straight to disk.
+// ✅ HtmlLinkSink: runs an incremental tokenizer that finds <a href> links and the <title>.
+// The tokenizer keeps its state between chunks, so a tag split across two chunks is still found.
+
+// 🖥️ Code: Page Sinks and Incremental HTML Tokenizer
+
+class PageSink {
+    public:
+        virtual ~PageSink() = default;
+        virtual void onData(const char* data, size_t size) = 0;
+        virtual void onEnd(long status) { (void)status; } // HTTP status, 0 on failure
+    };
+
+// cURL write callback that forwards each chunk to a sink
+size_t SinkWriteCallback(void* contents, size_t size, size_t nmemb, PageSink* sink) {
+    size_t totalSize = size * nmemb;
+    sink->onData(static_cast<const char*>(contents), totalSize);
+    return totalSize;
+}
+
+
+class ByteCountSink : public PageSink {
+    public:
+        size_t bytes = 0;
+
+        void onData(const char*, size_t size) override { bytes += size; }
+    };
+
+
+class FileSink : public PageSink {
+    private:
+        std::ofstream file;
+
+    public:
+        explicit FileSink(const std::string& path) : file(path, std::ios::binary) {
+            if (!file) throw std::runtime_error("Could not open output file");
+        }
+
+        void onData(const char* data, size_t size) override { file.write(data, size); }
+    };
+
+
+class HtmlTokenizer {
+    public:
+        std::function<void(const std::string& href)> onLink;
+        std::function<void(const std::string& title)> onTitle;
+
+        void feed(const char* data, size_t size) {
+            const char* end = data + size;
+            while (data < end) {
+                // Fast path: plain text outside <title> is skipped up to the next '<'
+                if (state == State::Text && !inTitle) {
+                    const char* tag = static_cast<const char*>(std::memchr(data, '<', end - data));
+                    if (!tag) return;
+                    data = tag;
+                }
+                step(*data++);
+            }
+        }
+
+    private:
+        enum class State { Text, TagName, Attributes, AttrName, AfterAttrName, BeforeValue, QuotedValue, UnquotedValue, Comment };
+
+        static constexpr size_t kMaxName = 16;     // Longer tag/attribute names can't be ones we care about
+        static constexpr size_t kMaxValue = 2048;  // Longer hrefs are dropped
+        static constexpr size_t kMaxTitle = 1024;  // Longer titles are cut off
+
+        State state = State::Text;
+        std::string tagName, attrName, value, title;
+        char quote = 0;
+        bool inTitle = false;
+        bool capturing = false; // Current attribute value is an <a href>
+        bool valueTooLong = false;
+        int commentDashes = 0;
+
+        static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+        static char lower(char c) { return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c; }
+
+        static void appendCapped(std::string& s, char c, size_t cap) {
+            if (s.size() < cap) s += c;
+        }
+
+        void appendValue(char c) {
+            if (!capturing) return;
+            if (value.size() < kMaxValue) value += c;
+            else valueTooLong = true;
+        }
+
+        void startValue() {
+            value.clear();
+            capturing = tagName == "a" && attrName == "href";
+            valueTooLong = false;
+        }
+
+        void finishAttribute() {
+            if (capturing && !valueTooLong && !value.empty() && onLink) onLink(value);
+            capturing = false;
+            attrName.clear();
+        }
+
+        void finishTag() {
+            state = State::Text;
+            if (tagName == "title") {
+                inTitle = true;
+                title.clear();
+            } else if (tagName == "/title" && inTitle) {
+                inTitle = false;
+                if (onTitle) onTitle(title);
+            }
+        }
+
+        void step(char c) {
+            switch (state) {
+                case State::Text:
+                    if (c == '<') {
+                        state = State::TagName;
+                        tagName.clear();
+                    } else if (inTitle) {
+                        appendCapped(title, c, kMaxTitle);
+                    }
+                    break;
+
+                case State::TagName:
+                    if (c == '>') {
+                        finishTag();
+                    } else if (isSpace(c) || (c == '/' && !tagName.empty())) {
+                        state = State::Attributes;
+                    } else {
+                        appendCapped(tagName, lower(c), kMaxName);
+                        if (tagName == "!--") {
+                            state = State::Comment;
+                            commentDashes = 0;
+                        }
+                    }
+                    break;
+
+                case State::Attributes:
+                    if (c == '>') {
+                        finishTag();
+                    } else if (!isSpace(c) && c != '/') {
+                        attrName.assign(1, lower(c));
+                        state = State::AttrName;
+                    }
+                    break;
+
+                case State::AttrName:
+                    if (c == '=') {
+                        state = State::BeforeValue;
+                    } else if (c == '>') {
+                        finishAttribute();
+                        finishTag();
+                    } else if (isSpace(c)) {
+                        state = State::AfterAttrName;
+                    } else {
+                        appendCapped(attrName, lower(c), kMaxName);
+                    }
+                    break;
+
+                case State::AfterAttrName:
+                    if (c == '=') {
+                        state = State::BeforeValue;
+                    } else if (c == '>') {
+                        finishAttribute();
+                        finishTag();
+                    } else if (!isSpace(c)) {
+                        finishAttribute(); // Attribute without a value, e.g. <a download href=...>
+                        attrName.assign(1, lower(c));
+                        state = State::AttrName;
+                    }
+                    break;
+
+                case State::BeforeValue:
+                    if (c == '"' || c == '\'') {
+                        quote = c;
+                        startValue();
+                        state = State::QuotedValue;
+                    } else if (c == '>') {
+                        finishAttribute();
+                        finishTag();
+                    } else if (!isSpace(c)) {
+                        startValue();
+                        appendValue(c);
+                        state = State::UnquotedValue;
+                    }
+                    break;
+
+                case State::QuotedValue:
+                    if (c == quote) {
+                        finishAttribute();
+                        state = State::Attributes;
+                    } else {
+                        appendValue(c);
+                    }
+                    break;
+
+                case State::UnquotedValue:
+                    if (c == '>') {
+                        finishAttribute();
+                        finishTag();
+                    } else if (isSpace(c)) {
+                        finishAttribute();
+                        state = State::Attributes;
+                    } else {
+                        appendValue(c);
+                    }
+                    break;
+
+                case State::Comment:
+                    // Skip everything up to "-->"
+                    if (c == '>' && commentDashes >= 2) state = State::Text;
+                    commentDashes = (c == '-') ? commentDashes + 1 : 0;
+                    break;
+            }
+        }
+    };
+
+
+class HtmlLinkSink : public PageSink {
+    public:
+        HtmlTokenizer tokenizer; // Set tokenizer.onLink / onTitle to receive results
+
+        void onData(const char* data, size_t size) override { tokenizer.feed(data, size); }
+    };
+
+
+// Fetches a page with a pooled handle and streams it into the sink; returns the HTTP status (0 on failure)
+long fetchURLStreaming(EasyHandlePool& pool, const std::string& url, PageSink& sink) {
+    CURL* curl = pool.acquire();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, SinkWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+
+    long status = 0;
+    CURLcode res = curl_easy_perform(curl);
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    } else {
+        std::cerr << "cURL Error: " << curl_easy_strerror(res) << "\n";
+    }
+    pool.release(curl);
+
+    sink.onEnd(status);
+    return status;
+}
+
+
+// Called once per finished transfer with the URL, HTTP status (0 on failure) and page body
+using FetchCallback = std::function<void(const std::string& url, long status, const std::string& body)>;
+
+// Keeps the whole page and hands it to a FetchCallback, for callers that really need the full body
+class BufferSink : public PageSink {
+    private:
+        std::string url;
+        std::string body;
+        const FetchCallback& onDone;
+
+    public:
+        BufferSink(std::string u, const FetchCallback& callback) : url(std::move(u)), onDone(callback) {}
+
+        void onData(const char* data, size_t size) override { body.append(data, size); }
+        void onEnd(long status) override { onDone(url, status, body); }
+    };
+
+// Creates the sink for one URL
+using SinkFactory = std::function<std::unique_ptr<PageSink>(const std::string& url)>;
+
+// A URL source either hands out the next URL, asks to be called again later (e.g. rate limited), or is finished
+enum class NextUrl { Ready, Later, Done };
+using UrlSource = std::function<NextUrl(std::string& url)>;
+
+
+
+// 📌 Step 6: HTTP Cache with a Content-Addressed Disk Store
+// Re-crawling re-downloads every page, even the ones that did not change.
+// ✅ HttpCache remembers each URL's ETag / Last-Modified and sends them back as If-None-Match / If-Modified-Since.
+//    An unchanged page then costs one "304 Not Modified" round-trip and no body transfer.
+// ✅ ContentStore keeps page bodies on disk, named by a hash of their content, so identical pages are stored once.
+//    Bodies are streamed to disk while they download and memory-mapped (mmap) when read back.
+// ✅ The URL -> (validators, content key) index is saved as index.tsv, so the cache survives restarts.
+
+// 🖥️ Code: Content Store and HTTP Cache
+
+// 128-bit content hash built from two 64-bit FNV-1a streams; fed chunk by chunk
+class ContentHasher {
+    private:
+        uint64_t a = 1469598103934665603ULL;
+        uint64_t b = 0x9ae16a3b2f90404fULL;
+
+    public:
+        void update(const char* data, size_t size) {
+            for (size_t i = 0; i < size; ++i) {
+                unsigned char c = static_cast<unsigned char>(data[i]);
+                a = (a ^ c) * 1099511628211ULL;
+                b = (b ^ c) * 0x100000001b3ULL + 0x9e3779b97f4a7c15ULL;
+            }
+        }
+
+        std::string hex() const {
+            char out[33];
+            std::snprintf(out, sizeof(out), "%016llx%016llx", static_cast<unsigned long long>(a), static_cast<unsigned long long>(b));
+            return out;
+        }
+    };
+
+
+// Read-only view of a file through mmap; unmapped when it goes out of scope
+class MappedFile {
+    private:
+        const char* bytes = nullptr;
+        size_t length = 0;
+
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open " + path);
+
+            struct stat info{};
+            fstat(fd, &info);
+            length = static_cast<size_t>(info.st_size);
+            if (length > 0) {
+                void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("Could not map " + path);
+                }
+                bytes = static_cast<const char*>(mapped);
+            }
+            close(fd); // The mapping stays valid without the descriptor
+        }
+
+        ~MappedFile() {
+            if (bytes) munmap(const_cast<char*>(bytes), length);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+    };
+
+
+class ContentStore {
+    private:
+        std::string dir;
+        std::atomic<size_t> tempCounter{0};
+
+    public:
+        explicit ContentStore(std::string directory) : dir(std::move(directory)) {
+            std::filesystem::create_directories(dir);
+        }
+
+        std::string pathFor(const std::string& key) const { return dir + "/" + key; }
+
+        // A fresh file name for a body that is still downloading
+        std::string tempPath() {
+            return dir + "/tmp-" + std::to_string(getpid()) + "-" + std::to_string(tempCounter++);
+        }
+
+        // Moves a finished download to its content-addressed name; drops it if that content is already stored
+        void commit(const std::string& temp, const std::string& key) {
+            std::error_code ec;
+            if (std::filesystem::exists(pathFor(key), ec)) std::filesystem::remove(temp, ec);
+            else std::filesystem::rename(temp, pathFor(key), ec);
+        }
+    };
+
+
+class HttpCache {
+    public:
+        struct Entry {
+            std::string etag;
+            std::string lastModified;
+            std::string contentKey;
+            size_t size = 0;
+        };
+
+        std::atomic<size_t> requests{0};
+        std::atomic<size_t> hits{0};            // Answered by 304 + the local copy
+        std::atomic<size_t> bytesSaved{0};      // Body bytes we did not have to download
+        std::atomic<size_t> bytesDownloaded{0};
+
+        ContentStore store;
+
+    private:
+        std::string indexPath;
+        mutable std::mutex mtx;
+        std::unordered_map<std::string, Entry> index;
+
+    public:
+        explicit HttpCache(const std::string& directory) : store(directory), indexPath(directory + "/index.tsv") {
+            // One line per URL: url <TAB> etag <TAB> last-modified <TAB> content key <TAB> size
+            std::ifstream file(indexPath);
+            std::string line;
+            while (std::getline(file, line)) {
+                std::vector<std::string> fields;
+                size_t start = 0, tab;
+                while ((tab = line.find('\t', start)) != std::string::npos) {
+                    fields.push_back(line.substr(start, tab - start));
+                    start = tab + 1;
+                }
+                fields.push_back(line.substr(start));
+                if (fields.size() != 5) continue;
+                index[fields[0]] = Entry{fields[1], fields[2], fields[3], std::strtoul(fields[4].c_str(), nullptr, 10)};
+            }
+        }
+
+        ~HttpCache() {
+            save();
+        }
+
+        HttpCache(const HttpCache&) = delete;
+        HttpCache& operator=(const HttpCache&) = delete;
+
+        bool lookup(const std::string& url, Entry& entry) const {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = index.find(url);
+            if (it == index.end()) return false;
+            entry = it->second;
+            return true;
+        }
+
+        void update(const std::string& url, Entry entry) {
+            std::lock_guard<std::mutex> lock(mtx);
+            index[url] = std::move(entry);
+        }
+
+        void forget(const std::string& url) {
+            std::lock_guard<std::mutex> lock(mtx);
+            index.erase(url);
+        }
+
+        void save() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::ofstream file(indexPath, std::ios::trunc);
+            for (const auto& [url, e] : index) {
+                file << url << '\t' << e.etag << '\t' << e.lastModified << '\t' << e.contentKey << '\t' << e.size << '\n';
+            }
+        }
+
+        double hitRate() const { return requests ? static_cast<double>(hits) / requests : 0.0; }
+    };
+
+
+// Fetches a page through the cache and streams it into the sink: from the network on a miss,
+// from the memory-mapped local copy when the server answers 304. Returns the HTTP status (0 on failure).
+long fetchURLCached(EasyHandlePool& pool, HttpCache& cache, const std::string& url, PageSink& sink) {
+    // Collects the validators of the response
+    struct Headers {
+        std::string etag;
+        std::string lastModified;
+
+        static size_t callback(char* line, size_t size, size_t nmemb, Headers* headers) {
+            std::string header(line, size * nmemb);
+            if (header.rfind("HTTP/", 0) == 0) *headers = Headers{}; // New response (e.g. after a redirect)
+            size_t colon = header.find(':');
+            if (colon != std::string::npos) {
+                std::string name = header.substr(0, colon);
+                for (auto& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                size_t start = header.find_first_not_of(' ', colon + 1);
+                size_t end = header.find_last_not_of("\r\n");
+                std::string value = (start == std::string::npos || end < start) ? "" : header.substr(start, end - start + 1);
+                if (name == "etag") headers->etag = value;
+                else if (name == "last-modified") headers->lastModified = value;
+            }
+            return size * nmemb;
+        }
+    };
+
+    // Tees the body into the sink and into a temp file in the store, hashing it on the way
+    class StoreWriter : public PageSink {
+        public:
+            PageSink& next;
+            std::ofstream file;
+            ContentHasher hasher;
+            size_t bytes = 0;
+
+            StoreWriter(PageSink& sink, const std::string& path) : next(sink), file(path, std::ios::binary) {}
+
+            void onData(const char* data, size_t size) override {
+                next.onData(data, size);
+                file.write(data, size);
+                hasher.update(data, size);
+                bytes += size;
+            }
+    };
+
+    ++cache.requests;
+    // A second round only if the server answered 304 for a body the store has lost
+    for (;;) {
+        HttpCache::Entry cached;
+        bool haveCopy = cache.lookup(url, cached);
+
+        curl_slist* conditions = nullptr;
+        if (haveCopy && !cached.etag.empty()) conditions = curl_slist_append(conditions, ("If-None-Match: " + cached.etag).c_str());
+        if (haveCopy && !cached.lastModified.empty()) conditions = curl_slist_append(conditions, ("If-Modified-Since: " + cached.lastModified).c_str());
+
+        Headers headers;
+        std::string temp = cache.store.tempPath();
+        StoreWriter writer(sink, temp);
+        if (!writer.file) throw std::runtime_error("Could not open cache file " + temp);
+
+        CURL* curl = pool.acquire();
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, conditions);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, Headers::callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, SinkWriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, static_cast<PageSink*>(&writer));
+
+        long status = 0;
+        CURLcode res = curl_easy_perform(curl);
+        if (res == CURLE_OK) {
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+        } else {
+            std::cerr << "cURL Error: " << curl_easy_strerror(res) << "\n";
+        }
+
+        // Pooled handles are shared: undo the per-request options before giving it back
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+        pool.release(curl);
+        curl_slist_free_all(conditions);
+        writer.file.close();
+
+        std::error_code ec;
+        if (status == 304 && haveCopy) {
+            std::filesystem::remove(temp, ec);
+            std::optional<MappedFile> copy;
+            try {
+                copy.emplace(cache.store.pathFor(cached.contentKey));
+            } catch (const std::runtime_error&) {
+                // The stored body is gone: drop the entry and ask again without validators
+                cache.forget(url);
+                continue;
+            }
+            sink.onData(copy->data(), copy->size());
+            ++cache.hits;
+            cache.bytesSaved += copy->size();
+            status = 200; // The caller got the full page
+        } else if (status == 200 && (!headers.etag.empty() || !headers.lastModified.empty())) {
+            std::string key = writer.hasher.hex();
+            cache.store.commit(temp, key);
+            cache.bytesDownloaded += writer.bytes;
+            cache.update(url, HttpCache::Entry{headers.etag, headers.lastModified, key, writer.bytes});
+        } else {
+            // Not cacheable (no validators to revalidate it with) or not a page: keep nothing on disk
+            if (status == 200) cache.bytesDownloaded += writer.bytes;
+            std::filesystem::remove(temp, ec);
+        }
+
+        sink.onEnd(status);
+        return status;
+    }
+}
+
+
+
+// 📌 Step 7: Event-Driven Multiplexed Fetcher (curl multi interface)
+// std::async starts one thread per URL, and every thread sits blocked inside curl_easy_perform.
+// That works for 3 URLs but not for a 100k-URL crawl.
+// The curl multi interface lets ONE thread drive thousands of transfers by waiting on all of their sockets at once.
+// ✅ maxInFlight caps how many transfers (and sockets) are open at the same time.
+// ✅ A few event loops (one thread each) split the URL list between them to use more than one core.
+
+// 🖥️ Code: Multiplexed Fetcher
+
+class MultiFetcher {
+    private:
+        struct Transfer {
+            CURL* easy = nullptr;
+            std::string url;
+            std::unique_ptr<PageSink> sink;
+        };
+
+        CURLM* multi;
+        size_t maxInFlight;
+        CurlShare* share; // Optional DNS/TLS cache shared with other fetchers
+
+        void startTransfer(Transfer* transfer) {
+            // Each slot keeps its handle (and its keep-alive connection) for the next URL
+            if (!transfer->easy) {
+                transfer->easy = curl_easy_init();
+                curl_easy_setopt(transfer->easy, CURLOPT_WRITEFUNCTION, SinkWriteCallback);
+                curl_easy_setopt(transfer->easy, CURLOPT_FOLLOWLOCATION, 1L);
+                curl_easy_setopt(transfer->easy, CURLOPT_PRIVATE, transfer); // Find the slot again when it finishes
+                if (share) curl_easy_setopt(transfer->easy, CURLOPT_SHARE, share->get());
+            }
+            curl_easy_setopt(transfer->easy, CURLOPT_URL, transfer->url.c_str());
+            curl_easy_setopt(transfer->easy, CURLOPT_WRITEDATA, transfer->sink.get());
+            curl_multi_add_handle(multi, transfer->easy);
+        }
+
+    public:
+        explicit MultiFetcher(size_t maxInFlight, CurlShare* share = nullptr)
+            : multi(curl_multi_init()), maxInFlight(std::max<size_t>(1, maxInFlight)), share(share) {
+            curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(this->maxInFlight));
+        }
+
+        ~MultiFetcher() {
+            curl_multi_cleanup(multi);
+        }
+
+        MultiFetcher(const MultiFetcher&) = delete;
+        MultiFetcher& operator=(const MultiFetcher&) = delete;
+
+        // Buffers each page in memory and passes it to onDone
+        void fetchAll(const std::vector<std::string>& urls, const FetchCallback& onDone) {
+            streamAll(urls, [&onDone](const std::string& url) { return std::make_unique<BufferSink>(url, onDone); });
+        }
+
+        // Streams each page into the sink made for it; the sink's onEnd runs when the transfer finishes
+        void streamAll(const std::vector<std::string>& urls, const SinkFactory& makeSink) {
+            size_t next = 0;
+            streamFrom([&](std::string& url) {
+                if (next == urls.size()) return NextUrl::Done;
+                url = urls[next++];
+                return NextUrl::Ready;
+            }, makeSink);
+        }
+
+        // Pulls URLs from the source while slots are free, so new URLs can be added during the crawl
+        void streamFrom(const UrlSource& source, const SinkFactory& makeSink) {
+            // One slot per in-flight transfer; a URL is only copied into a slot when its transfer starts
+            std::vector<Transfer> slots(maxInFlight);
+            std::vector<Transfer*> freeSlots;
+            for (auto& slot : slots) freeSlots.push_back(&slot);
+
+            bool sourceDone = false;
+            int running = 0;
+            do {
+                // Keep the pipeline full up to maxInFlight transfers
+                bool sourceWaiting = false;
+                while (!sourceDone && !freeSlots.empty()) {
+                    std::string url;
+                    NextUrl result = source(url);
+                    if (result == NextUrl::Done) sourceDone = true;
+                    if (result != NextUrl::Ready) {
+                        sourceWaiting = (result == NextUrl::Later);
+                        break;
+                    }
+
+                    Transfer* transfer = freeSlots.back();
+                    freeSlots.pop_back();
+                    transfer->url = std::move(url);
+                    transfer->sink = makeSink(transfer->url);
+                    startTransfer(transfer);
+                }
+
+                curl_multi_perform(multi, &running);
+
+                // Hand finished transfers to the caller and recycle their slots
+                int queued = 0;
+                while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                    if (msg->msg != CURLMSG_DONE) continue;
+
+                    char* privateData = nullptr;
+                    curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &privateData);
+                    Transfer* transfer = reinterpret_cast<Transfer*>(privateData);
+
+                    long status = 0;
+                    if (msg->data.result == CURLE_OK) {
+                        curl_easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &status);
+                    } else {
+                        std::cerr << "cURL Error: " << curl_easy_strerror(msg->data.result) << "\n";
+                    }
+
+                    curl_multi_remove_handle(multi, transfer->easy);
+
+                    transfer->sink->onEnd(status);
+                    transfer->sink.reset();
+                    freeSlots.push_back(transfer);
+                }
+
+                // Sleep until any socket is ready instead of spinning; wake up sooner if the source asked us to retry later
+                if (running > 0 || sourceWaiting) curl_multi_poll(multi, nullptr, 0, sourceWaiting ? 5 : 1000, nullptr);
+            } while (running > 0 || !sourceDone);
+
+            for (auto& slot : slots) {
+                if (slot.easy) curl_easy_cleanup(slot.easy);
+            }
+        }
+    };
+
+
+// Summary of a multiplexed crawl
+struct ScrapeStats {
+    size_t pages = 0;
+    size_t bytes = 0;
+    size_t failures = 0;
+};
+
+// Splits the URLs across numLoops event loops that share the maxInFlight budget (and the share, if given).
+// Pages are only counted as they stream by, never buffered.
+ScrapeStats scrapeWebsitesMultiplexed(const std::vector<std::string>& urls, size_t numLoops, size_t maxInFlight,
+                                      CurlShare* share = nullptr) {
+    numLoops = std::max<size_t>(1, numLoops);
+    struct Totals {
+        std::atomic<size_t> pages{0}, bytes{0}, failures{0};
+    } totals;
+
+    // Adds one page's byte count to the totals when its transfer ends
+    class CountingSink : public ByteCountSink {
+        private:
+            Totals& totals;
+
+        public:
+            explicit CountingSink(Totals& t) : totals(t) {}
+
+            void onEnd(long status) override {
+                if (status == 0) {
+                    ++totals.failures;
+                } else {
+                    ++totals.pages;
+                    totals.bytes += bytes;
+                }
+            }
+    };
+
+    std::vector<std::thread> loops;
+    for (size_t loop = 0; loop < numLoops; ++loop) {
+        loops.emplace_back([&, loop] {
+            std::vector<std::string> shard;
+            for (size_t i = loop; i < urls.size(); i += numLoops) shard.push_back(urls[i]);
+
+            MultiFetcher fetcher(maxInFlight / numLoops, share);
+            fetcher.streamAll(shard, [&totals](const std::string&) { return std::make_unique<CountingSink>(totals); });
+        });
+    }
+
+    for (auto& t : loops) t.join();
+    return ScrapeStats{totals.pages.load(), totals.bytes.load(), totals.failures.load()};
+}
+
+
+
+// 📌 Step 8: Crawl Frontier with Deduplication and Per-Host Rate Limits
+// scrapeWebsites takes a flat list of URLs. A crawler instead follows the links it finds, which raises three problems:
+// ✅ Dedup: the same URL is linked from many pages. A Bloom filter remembers every URL seen in a fixed number of bits
+//    (about 1.2 bytes per URL at a 1% false-positive rate, so 100M URLs fit in ~120 MB). A false positive only skips a page.
+// ✅ Politeness: each host gets a token bucket (requests/sec + burst) and a cap on parallel requests.
+// ✅ Fairness: hosts with queued URLs are served round-robin, so one huge site can't starve the others.
+// The queue is capped too (maxQueuedUrls); links found once it is full are dropped and counted.
+
+// 🖥️ Code: Bloom Filter, Token Bucket and Crawl Frontier
+
+// 64-bit FNV-1a followed by a bit mixer, so nearby strings land far apart
+uint64_t hashString(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+class BloomFilter {
+    private:
+        std::vector<uint64_t> bits;
+        uint64_t numBits;
+        int numHashes;
+
+    public:
+        BloomFilter(size_t expectedItems, double falsePositiveRate) {
+            double ln2 = std::log(2.0);
+            double n = static_cast<double>(std::max<size_t>(1, expectedItems));
+            numBits = std::max<uint64_t>(64, static_cast<uint64_t>(-n * std::log(falsePositiveRate) / (ln2 * ln2)));
+            numHashes = std::max(1, static_cast<int>(std::round(numBits / n * ln2)));
+            bits.assign((numBits + 63) / 64, 0);
+        }
+
+        // Returns true if the item was (probably) not seen before, and marks it as seen
+        bool insert(const std::string& item) {
+            uint64_t h1 = hashString(item);
+            uint64_t h2 = (h1 >> 32 | h1 << 32) | 1; // Second hash for double hashing: h1 + i * h2
+            bool isNew = false;
+            for (int i = 0; i < numHashes; ++i) {
+                uint64_t bit = (h1 + i * h2) % numBits;
+                uint64_t mask = 1ULL << (bit % 64);
+                if (!(bits[bit / 64] & mask)) {
+                    bits[bit / 64] |= mask;
+                    isNew = true;
+                }
+            }
+            return isNew;
+        }
+
+        size_t memoryBytes() const { return bits.size() * sizeof(uint64_t); }
+    };
+
+
+// Returns "scheme://host[:port]" of an absolute URL, or "" if it has none
+std::string originOf(const std::string& url) {
+    size_t scheme = url.find("://");
+    if (scheme == std::string::npos) return "";
+    return url.substr(0, url.find_first_of("/?#", scheme + 3));
+}
+
+// Length of the link's scheme ("https" in "https://..."), or 0 if it is relative.
+// A scheme (RFC 3986 §3.1) is a letter, then letters, digits, '+', '-' or '.', and ends at a ':'
+// that comes before any '/', '?' or '#': "a?x=b:c" and "docs/a:b" are relative.
+size_t schemeLength(const std::string& link) {
+    size_t colon = link.find(':');
+    if (colon == std::string::npos || colon == 0 || colon > link.find_first_of("/?#")) return 0;
+    if (!std::isalpha(static_cast<unsigned char>(link[0]))) return 0;
+    for (size_t i = 1; i < colon; ++i) {
+        unsigned char c = static_cast<unsigned char>(link[i]);
+        if (!std::isalnum(c) && c != '+' && c != '-' && c != '.') return 0;
+    }
+    return colon;
+}
+
+// RFC 3986 §5.2.4 on an absolute path: "/a/b/../c/./d" -> "/a/c/d". ".." never climbs above the root.
+std::string removeDotSegments(const std::string& path) {
+    std::string out;
+    size_t start = 0;
+    while (start < path.size()) {
+        size_t next = path.find('/', start + 1);
+        std::string segment = path.substr(start, next - start); // With its leading '/'
+        bool last = next == std::string::npos;
+        if (segment == "/..") {
+            size_t slash = out.rfind('/');
+            if (slash != std::string::npos) out.erase(slash);
+            if (last) out += '/';
+        } else if (segment == "/.") {
+            if (last) out += '/';
+        } else {
+            out += segment;
+        }
+        start = next;
+    }
+    return out.empty() ? "/" : out;
+}
+
+// Turns a link found on baseUrl into an absolute http(s) URL without its #fragment; "" if it can't be crawled
+std::string resolveLink(const std::string& baseUrl, const std::string& link) {
+    std::string url = link.substr(0, link.find('#'));
+    if (url.empty()) return "";
+
+    size_t scheme = schemeLength(url);
+    if (scheme > 0) {
+        // Scheme and host are case-insensitive; the rest is lowercased below
+        for (size_t i = 0; i < scheme; ++i) url[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(url[i])));
+    } else if (url.rfind("//", 0) == 0) {
+        url = baseUrl.substr(0, schemeLength(baseUrl) + 1) + url; // Scheme-relative: //host/path
+    } else {
+        std::string origin = originOf(baseUrl);
+        std::string path = baseUrl.substr(origin.size());
+        if (url[0] == '/') {
+            url = origin + url;
+        } else if (url[0] == '?') {
+            url = origin + path.substr(0, path.find('?')) + url; // Same page, new query
+        } else {
+            // Relative to the directory of the base page
+            path = path.substr(0, path.find('?'));
+            size_t slash = path.rfind('/');
+            url = origin + (slash == std::string::npos ? "/" : path.substr(0, slash + 1)) + url;
+        }
+    }
+
+    if (url.rfind("http://", 0) != 0 && url.rfind("https://", 0) != 0) return ""; // mailto:, javascript:, ...
+
+    // Lowercase the host so dedup sees one spelling, and resolve "." and ".." in the path
+    size_t originLength = originOf(url).size();
+    for (size_t i = 0; i < originLength; ++i) url[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(url[i])));
+    size_t query = url.find('?', originLength);
+    std::string path = url.substr(originLength, query == std::string::npos ? std::string::npos : query - originLength);
+    if (!path.empty()) url.replace(originLength, path.size(), removeDotSegments(path));
+    return url;
+}
+
+
+class TokenBucket {
+    private:
+        double ratePerSecond;
+        double burst;
+        double tokens;
+        std::chrono::steady_clock::time_point last;
+
+    public:
+        TokenBucket(double rate, double burstSize)
+            : ratePerSecond(rate), burst(burstSize), tokens(burstSize), last(std::chrono::steady_clock::now()) {}
+
+        bool tryTake(std::chrono::steady_clock::time_point now) {
+            tokens = std::min(burst, tokens + std::chrono::duration<double>(now - last).count() * ratePerSecond);
+            last = now;
+            if (tokens < 1.0) return false;
+            tokens -= 1.0;
+            return true;
+        }
+    };
+
+
+class CrawlFrontier {
+    public:
+        struct Config {
+            size_t expectedUrls = 1000000;     // Sizes the Bloom filter; use 100000000 for a 100M-URL crawl
+            double falsePositiveRate = 0.01;
+            double requestsPerSecondPerHost = 10;
+            double burstPerHost = 5;
+            size_t maxInFlightPerHost = 4;
+            size_t maxQueuedUrls = 1000000;    // Bounds frontier memory
+        };
+
+        size_t duplicates = 0; // URLs skipped because they were already seen
+        size_t dropped = 0;    // URLs skipped because the queue was full
+
+    private:
+        struct Host {
+            std::deque<std::string> urls;
+            TokenBucket bucket;
+            size_t inFlight = 0;
+            bool active = false; // Listed in activeHosts
+
+            explicit Host(const Config& config) : bucket(config.requestsPerSecondPerHost, config.burstPerHost) {}
+        };
+
+        Config config;
+        BloomFilter seen;
+        std::unordered_map<std::string, Host> hosts;
+        std::deque<std::string> activeHosts; // Hosts with queued URLs, served round-robin
+        size_t queued = 0;
+        size_t inFlight = 0;
+
+        Host& hostFor(const std::string& origin) {
+            auto it = hosts.find(origin);
+            if (it == hosts.end()) it = hosts.emplace(origin, Host(config)).first;
+            return it->second;
+        }
+
+    public:
+        explicit CrawlFrontier(const Config& c) : config(c), seen(c.expectedUrls, c.falsePositiveRate) {}
+
+        // Queues an absolute URL unless it was seen before or the queue is full
+        bool add(const std::string& url) {
+            if (queued >= config.maxQueuedUrls) {
+                ++dropped;
+                return false;
+            }
+            if (!seen.insert(url)) {
+                ++duplicates;
+                return false;
+            }
+
+            std::string origin = originOf(url);
+            Host& host = hostFor(origin);
+            host.urls.push_back(url);
+            ++queued;
+            if (!host.active) {
+                host.active = true;
+                activeHosts.push_back(origin);
+            }
+            return true;
+        }
+
+        // Round-robin over hosts; a host is skipped while it is out of tokens or at its parallel limit
+        NextUrl next(std::string& url) {
+            if (queued == 0) return inFlight == 0 ? NextUrl::Done : NextUrl::Later;
+
+            auto now = std::chrono::steady_clock::now();
+            for (size_t tries = activeHosts.size(); tries > 0; --tries) {
+                std::string origin = std::move(activeHosts.front());
+                activeHosts.pop_front();
+                Host& host = hosts.at(origin);
+
+                if (host.inFlight < config.maxInFlightPerHost && host.bucket.tryTake(now)) {
+                    url = std::move(host.urls.front());
+                    host.urls.pop_front();
+                    --queued;
+                    ++host.inFlight;
+                    ++inFlight;
+                    if (host.urls.empty()) host.active = false;
+                    else activeHosts.push_back(std::move(origin));
+                    return NextUrl::Ready;
+                }
+                activeHosts.push_back(std::move(origin));
+            }
+            return NextUrl::Later;
+        }
+
+        // Must be called once for every URL handed out by next()
+        void finished(const std::string& url) {
+            --hosts.at(originOf(url)).inFlight;
+            --inFlight;
+        }
+
+        size_t hostCount() const { return hosts.size(); }
+        size_t seenSetBytes() const { return seen.memoryBytes(); }
+    };
+
+
+// Summary of a crawl
+struct CrawlStats {
+    size_t pages = 0;
+    size_t failures = 0;
+    size_t linksFound = 0;
+};
+
+// Crawls from the seed URLs, following links, until maxPages pages were requested or nothing is left
+CrawlStats crawl(const std::vector<std::string>& seeds, size_t maxPages, size_t maxInFlight, CrawlFrontier& frontier) {
+    CrawlStats stats;
+    for (const auto& seed : seeds) {
+        std::string url = resolveLink(seed, seed);
+        if (!url.empty()) frontier.add(url);
+    }
+
+    // Finishes one page: forwards every link it contains to the frontier
+    class CrawlSink : public HtmlLinkSink {
+        private:
+            std::string url;
+            CrawlFrontier& frontier;
+            CrawlStats& stats;
+
+        public:
+            CrawlSink(std::string u, CrawlFrontier& f, CrawlStats& s) : url(std::move(u)), frontier(f), stats(s) {
+                tokenizer.onLink = [this](const std::string& link) {
+                    ++stats.linksFound;
+                    std::string absolute = resolveLink(url, link);
+                    if (!absolute.empty()) frontier.add(absolute);
+                };
+            }
+
+            void onEnd(long status) override {
+                if (status == 0) ++stats.failures;
+                else ++stats.pages;
+                frontier.finished(url);
+            }
+    };
+
+    size_t requested = 0;
+    MultiFetcher fetcher(maxInFlight);
+    fetcher.streamFrom(
+        [&](std::string& url) {
+            if (requested >= maxPages) return stats.pages + stats.failures == requested ? NextUrl::Done : NextUrl::Later;
+            NextUrl result = frontier.next(url);
+            if (result == NextUrl::Ready) ++requested;
+            return result;
+        },
+        [&](const std::string& url) { return std::make_unique<CrawlSink>(url, frontier, stats); });
+
+    return stats;
+}
+
+
+
+// 📌 Step 9: Local HTTP Stand-In Server
+// Benchmarking against real websites measures the internet, not our code.
+// This tiny HTTP/1.1 server runs on loopback (127.0.0.1) in a background thread.
+// ✅ A single poll() loop serves every connection, with keep-alive and pipelining.
+// ✅ The handler decides the page body for each request path.
+// ✅ Optionally it tags pages with an ETag and answers "304 Not Modified" to matching If-None-Match requests.
+
+// 🖥️ Code: Local HTTP Server
+
+class LocalHttpServer {
+    private:
+        struct Connection {
+            int fd = -1;
+            std::string in;          // Bytes received but not yet parsed
+            std::string out;         // Response bytes waiting to be sent
+            size_t outPos = 0;       // How much of out has been sent already
+            bool closeAfterWrite = false;
+        };
+
+        std::function<std::string(const std::string& path)> handler;
+        bool sendETags;        // Add an ETag to responses and honor If-None-Match
+        int listenFd = -1;
+        uint16_t port = 0;
+        std::atomic<bool> stop{false};
+        std::thread loop;
+
+        // Value of a request header (name in lowercase), or "" if it is missing
+        static std::string headerValue(const std::string& head, const std::string& name) {
+            std::string lowerHead = head;
+            for (auto& c : lowerHead) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            size_t pos = lowerHead.find("\r\n" + name + ":");
+            if (pos == std::string::npos) return "";
+            size_t start = head.find_first_not_of(' ', pos + name.size() + 3);
+            size_t end = head.find("\r\n", start);
+            return head.substr(start, end - start);
+        }
+
+        static void setNonBlocking(int fd) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+
+        // Parse every complete request in the input buffer and queue a response for each
+        void handleInput(Connection& conn) {
+            size_t headerEnd;
+            while ((headerEnd = conn.in.find("\r\n\r\n")) != std::string::npos) {
+                std::string head = conn.in.substr(0, headerEnd);
+                conn.in.erase(0, headerEnd + 4);
+
+                // Request line: GET /path HTTP/1.1
+                size_t pathStart = head.find(' ') + 1;
+                size_t pathEnd = head.find(' ', pathStart);
+                std::string path = head.substr(pathStart, pathEnd - pathStart);
+                if (head.find("Connection: close") != std::string::npos) conn.closeAfterWrite = true;
+
+                std::string body = handler(path);
+                std::string etagHeader;
+                if (sendETags) {
+                    char etag[19];
+                    std::snprintf(etag, sizeof(etag), "\"%016llx\"", static_cast<unsigned long long>(hashString(body)));
+                    if (headerValue(head, "if-none-match") == etag) {
+                        // The client's copy is current: answer without a body
+                        conn.out += "HTTP/1.1 304 Not Modified\r\nETag: " + std::string(etag) + "\r\n\r\n";
+                        continue;
+                    }
+                    etagHeader = "ETag: " + std::string(etag) + "\r\n";
+                }
+                conn.out += "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n" + etagHeader + "Content-Length: "
+                          + std::to_string(body.size()) + "\r\n\r\n";
+                conn.out += body;
+            }
+        }
+
+        void run() {
+            std::vector<Connection> conns;
+            std::vector<pollfd> fds;
+
+            while (!stop) {
+                fds.clear();
+                fds.push_back({listenFd, POLLIN, 0});
+                for (const auto& c : conns) {
+                    fds.push_back({c.fd, static_cast<short>(c.outPos < c.out.size() ? POLLIN | POLLOUT : POLLIN), 0});
+                }
+                if (poll(fds.data(), fds.size(), 50) <= 0) continue;
+
+                // fds[i + 1] belongs to conns[i]; accepted connections are only polled next round
+                size_t polled = conns.size();
+                for (size_t i = 0; i < polled; ++i) {
+                    Connection& c = conns[i];
+                    short events = fds[i + 1].revents;
+                    bool dead = (events & (POLLERR | POLLNVAL)) != 0;
+
+                    if (events & (POLLIN | POLLHUP)) {
+                        char buffer[16384];
+                        ssize_t n;
+                        while ((n = recv(c.fd, buffer, sizeof(buffer), 0)) > 0) c.in.append(buffer, n);
+                        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) dead = true;
+                        handleInput(c);
+                    }
+
+                    if (!dead && c.outPos < c.out.size()) {
+                        ssize_t n = send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos, 0);
+                        if (n > 0) c.outPos += n;
+                        else if (errno != EAGAIN && errno != EWOULDBLOCK) dead = true;
+                    }
+                    if (c.outPos == c.out.size()) {
+                        c.out.clear();
+                        c.outPos = 0;
+                        if (c.closeAfterWrite) dead = true;
+                    }
+
+                    if (dead) {
+                        close(c.fd);
+                        c.fd = -1;
+                    }
+                }
+                conns.erase(std::remove_if(conns.begin(), conns.end(), [](const Connection& c) { return c.fd < 0; }),
+                            conns.end());
+
+                if (fds[0].revents & POLLIN) {
+                    int fd;
+                    while ((fd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                        setNonBlocking(fd);
+                        Connection conn;
+                        conn.fd = fd;
+                        conns.push_back(std::move(conn));
+                    }
+                }
+            }
+
+            for (auto& c : conns) close(c.fd);
+        }
+
+    public:
+        explicit LocalHttpServer(std::function<std::string(const std::string& path)> h, bool etags = false)
+            : handler(std::move(h)), sendETags(etags) {
+            signal(SIGPIPE, SIG_IGN); // A client hanging up must not kill the process
+
+            listenFd = socket(AF_INET, SOCK_STREAM, 0);
+            if (listenFd < 0) throw std::runtime_error("Could not create server socket");
+
+            int on = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0; // Let the OS pick a free port
+            socklen_t len = sizeof(addr);
+            if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+                listen(listenFd, SOMAXCONN) < 0 ||
+                getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len) < 0) {
+                close(listenFd);
+                throw std::runtime_error("Could not start local HTTP server");
+            }
+            port = ntohs(addr.sin_port);
+            setNonBlocking(listenFd);
+
+            loop = std::thread(&LocalHttpServer::run, this);
+        }
+
+        ~LocalHttpServer() {
+            stop = true;
+            loop.join();
+            close(listenFd);
+        }
+
+        LocalHttpServer(const LocalHttpServer&) = delete;
+        LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+
+        std::string url(const std::string& path) const {
+            return "http://127.0.0.1:" + std::to_string(port) + path;
+        }
+    };
+
+
+
+// 📌 Step 10: Benchmarks Against the Local Server
+// Every version fetches the same pages from the local server; we report pages (requests) per second.
+// A second benchmark fetches large pages and compares peak memory of buffering vs. streaming.
+// A third one crawls a set of linked mock sites through the frontier.
+// The last one re-crawls the same pages through the HTTP cache and reports hit rate and bytes saved.
+
+// 🖥️ Code: Scraper Benchmark
+
+void runScraperBenchmark(size_t numUrls, size_t pageSize) {
+    LocalHttpServer server([pageSize](const std::string&) { return std::string(pageSize, 'x'); });
+
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < numUrls; ++i) urls.push_back(server.url("/page/" + std::to_string(i)));
+
+    auto report = [numUrls](const std::string& name, std::chrono::steady_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << name << ": " << numUrls << " pages in " << seconds * 1000 << " ms ("
+                  << static_cast<size_t>(numUrls / seconds) << " pages/sec)\n";
+    };
+
+    std::cout << "Benchmark: " << numUrls << " URLs, " << pageSize << " bytes per page, local server at "
+              << server.url("/") << "\n";
+
+    // Baseline: one std::async thread and one blocking fetchURL per page
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::future<std::string>> futures;
+        for (const auto& url : urls) futures.push_back(std::async(std::launch::async, fetchURL, url));
+        for (auto& f : futures) f.get();
+    }
+    report("std::async per URL              ", std::chrono::steady_clock::now() - start);
+
+    // Handle pooling: a few workers fetch their share of the pages one after another
+    const size_t numWorkers = 8;
+    auto runWorkers = [&urls, numWorkers](const std::function<std::string(const std::string&)>& fetch) {
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < numWorkers; ++w) {
+            workers.emplace_back([&, w] {
+                for (size_t i = w; i < urls.size(); i += numWorkers) fetch(urls[i]);
+            });
+        }
+        for (auto& t : workers) t.join();
+    };
+
+    start = std::chrono::steady_clock::now();
+    runWorkers(fetchURL);
+    report("8 workers, new handle per URL   ", std::chrono::steady_clock::now() - start);
+
+    CurlShare share;
+    EasyHandlePool pool(share);
+    start = std::chrono::steady_clock::now();
+    runWorkers([&pool](const std::string& url) { return fetchURLPooled(pool, url); });
+    report("8 workers, pooled handles       ", std::chrono::steady_clock::now() - start);
+
+    for (size_t loops : {1, 2, 4}) {
+        for (size_t maxInFlight : {64, 256}) {
+            start = std::chrono::steady_clock::now();
+            ScrapeStats stats = scrapeWebsitesMultiplexed(urls, loops, maxInFlight);
+            std::string name = "multi: " + std::to_string(loops) + " loop(s), " + std::to_string(maxInFlight) + " in flight";
+            name.resize(32, ' ');
+            report(name, std::chrono::steady_clock::now() - start);
+            if (stats.failures) std::cout << "  (" << stats.failures << " failed)\n";
+        }
+    }
+
+    start = std::chrono::steady_clock::now();
+    scrapeWebsitesMultiplexed(urls, 4, 64, &share);
+    report("multi: 4 loop(s), shared cache  ", std::chrono::steady_clock::now() - start);
+}
+
+
+
+// Streaming vs. buffering: peak memory while fetching large pages.
+// Each mode runs in a forked child process so its peak RSS isn't mixed up with the server's or the other mode's.
+long peakMemoryGrowthKB(const std::function<void()>& work) {
+    int fds[2];
+    if (pipe(fds) < 0) throw std::runtime_error("Could not create pipe");
+
+    std::cout.flush(); // Otherwise the child inherits (and prints again) our pending output
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        long pageKB = sysconf(_SC_PAGESIZE) / 1024;
+        long sizePages = 0, residentPages = 0;
+        std::ifstream("/proc/self/statm") >> sizePages >> residentPages;
+
+        work();
+        std::cout.flush(); // _exit skips the normal flush
+
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        long grownKB = usage.ru_maxrss - residentPages * pageKB;
+        ssize_t written = write(fds[1], &grownKB, sizeof(grownKB));
+        _exit(written == sizeof(grownKB) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    long grownKB = -1;
+    if (read(fds[0], &grownKB, sizeof(grownKB)) != sizeof(grownKB)) grownKB = -1;
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return grownKB;
+}
+
+void runStreamingBenchmark(size_t numPages, size_t pageSize, size_t maxInFlight) {
+    // One large HTML page full of links, served for every URL
+    std::string page = "<html><head><title>Large Test Page</title></head><body>\n";
+    for (size_t i = 0; page.size() < pageSize; ++i) {
+        page += "<p>Lorem ipsum dolor sit amet <a href=\"/page/" + std::to_string(i) + "\">link " + std::to_string(i) + "</a></p>\n";
+    }
+    page += "</body></html>\n";
+    LocalHttpServer server([&page](const std::string&) { return page; });
+
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < numPages; ++i) urls.push_back(server.url("/big/" + std::to_string(i)));
+
+    std::cout << "\nStreaming benchmark: " << numPages << " pages of " << page.size() / (1024 * 1024)
+              << " MB, " << maxInFlight << " in flight\n";
+
+    std::atomic<size_t> links{0};
+    auto start = std::chrono::steady_clock::now();
+    long bufferedKB = peakMemoryGrowthKB([&] {
+        MultiFetcher fetcher(maxInFlight);
+        fetcher.fetchAll(urls, [](const std::string&, long, const std::string&) {});
+    });
+    double bufferedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    long streamedKB = peakMemoryGrowthKB([&] {
+        MultiFetcher fetcher(maxInFlight);
+        fetcher.streamAll(urls, [&links](const std::string&) {
+            auto sink = std::make_unique<HtmlLinkSink>();
+            sink->tokenizer.onLink = [&links](const std::string&) { ++links; };
+            return sink;
+        });
+        std::cout << "  streaming found " << links << " links\n";
+    });
+    double streamedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double totalMB = static_cast<double>(numPages) * page.size() / (1024 * 1024);
+    std::cout << "buffered std::string   : peak RSS +" << bufferedKB / 1024 << " MB, "
+              << static_cast<size_t>(totalMB / bufferedSeconds) << " MB/s\n";
+    std::cout << "streaming HtmlLinkSink : peak RSS +" << streamedKB / 1024 << " MB, "
+              << static_cast<size_t>(totalMB / streamedSeconds) << " MB/s (incl. link extraction)\n";
+}
+
+
+
+// Crawl test: several mock sites (one local server each, so each has its own host:port) link to each other.
+// Every page links to random pages on its own site and to one page on another site, with plenty of duplicates.
+void runCrawlBenchmark(size_t numSites, size_t pagesPerSite, double requestsPerSecondPerHost) {
+    std::mutex sitesMtx;
+    std::vector<std::string> siteUrls; // Filled once all servers are up; read by the handlers
+
+    auto makePage = [&, pagesPerSite](size_t site, const std::string& path) {
+        size_t page = path.rfind("/p/", 0) == 0 ? std::strtoul(path.c_str() + 3, nullptr, 10) : 0;
+        std::string html = "<html><head><title>Site " + std::to_string(site) + " page " + std::to_string(page) + "</title></head><body>\n";
+        uint64_t h = hashString(path);
+        for (int i = 0; i < 8; ++i) {
+            h = h * 6364136223846793005ULL + 1442695040888963407ULL;
+            html += "<a href=\"" + std::string(i % 2 ? "/p/" : "") + std::to_string((h >> 33) % pagesPerSite) + "\">more</a>\n";
+        }
+        std::lock_guard<std::mutex> lock(sitesMtx);
+        if (!siteUrls.empty()) {
+            html += "<a href=\"" + siteUrls[(site + 1) % siteUrls.size()] + "/p/" + std::to_string(page) + "\">next site</a>\n";
+        }
+        return html + "</body></html>\n";
+    };
+
+    std::vector<std::unique_ptr<LocalHttpServer>> sites;
+    for (size_t site = 0; site < numSites; ++site) {
+        // Relative links ("17") resolve against /p/, so they land on /p/17 as well
+        sites.push_back(std::make_unique<LocalHttpServer>([&, site](const std::string& path) { return makePage(site, path); }));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sitesMtx);
+        for (auto& site : sites) siteUrls.push_back(site->url(""));
+    }
+
+    CrawlFrontier::Config config;
+    config.requestsPerSecondPerHost = requestsPerSecondPerHost;
+    config.burstPerHost = 10;
+    CrawlFrontier frontier(config);
+
+    size_t expectedPages = numSites * pagesPerSite;
+    std::cout << "\nCrawl benchmark: " << numSites << " sites x " << pagesPerSite << " pages, "
+              << requestsPerSecondPerHost << " req/s per host\n";
+
+    auto start = std::chrono::steady_clock::now();
+    CrawlStats stats = crawl({siteUrls[0] + "/p/0"}, expectedPages * 2, 64, frontier);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "crawled " << stats.pages << " pages (" << stats.failures << " failed) from "
+              << frontier.hostCount() << " hosts in " << seconds << " s\n";
+    std::cout << "links found: " << stats.linksFound << ", duplicates skipped: " << frontier.duplicates
+              << ", dropped: " << frontier.dropped << "\n";
+    std::cout << "per-host rate: " << stats.pages / seconds / numSites << " req/s (limit "
+              << requestsPerSecondPerHost << " + burst " << config.burstPerHost << ")\n";
+    std::cout << "seen set: " << frontier.seenSetBytes() / 1024 << " KB for " << config.expectedUrls
+              << " URLs (" << BloomFilter(100000000, 0.01).memoryBytes() / (1024 * 1024) << " MB for 100M)\n";
+}
+
+
+
+// HTTP cache: crawl the same pages several times. Between rounds 10% of the pages change,
+// so the cache should answer ~90% with a 304 and re-download only the changed ones.
+void runCacheBenchmark(size_t numPages, size_t pageSize, int rounds) {
+    std::atomic<int> round{0};
+    LocalHttpServer server([&round, pageSize](const std::string& path) {
+        size_t page = std::strtoul(path.c_str() + path.rfind('/') + 1, nullptr, 10);
+        int version = page % 10 == 0 ? round.load() : 0; // Every 10th page changes each round
+        std::string html = "<html><head><title>Page " + std::to_string(page) + " v" + std::to_string(version) + "</title></head><body>";
+        html.resize(pageSize, 'x');
+        return html;
+    }, true);
+
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < numPages; ++i) urls.push_back(server.url("/cached/" + std::to_string(i)));
+
+    std::string dir = (std::filesystem::temp_directory_path() / ("scraper-cache-" + std::to_string(getpid()))).string();
+    std::cout << "\nCache benchmark: " << numPages << " pages of " << pageSize / 1024 << " KB, " << rounds
+              << " rounds, cache in " << dir << "\n";
+    {
+        HttpCache cache(dir);
+        CurlShare share;
+        EasyHandlePool pool(share);
+
+        for (int r = 0; r < rounds; ++r) {
+            round = r;
+            size_t requestsBefore = cache.requests, hitsBefore = cache.hits;
+            size_t savedBefore = cache.bytesSaved, downloadedBefore = cache.bytesDownloaded;
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (size_t w = 0; w < 8; ++w) {
+                workers.emplace_back([&, w] {
+                    for (size_t i = w; i < urls.size(); i += 8) {
+                        ByteCountSink sink;
+                        fetchURLCached(pool, cache, urls[i], sink);
+                    }
+                });
+            }
+            for (auto& t : workers) t.join();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            size_t requests = cache.requests - requestsBefore, hits = cache.hits - hitsBefore;
+            std::cout << "round " << r + 1 << ": hit rate " << 100.0 * hits / requests << "%, downloaded "
+                      << (cache.bytesDownloaded - downloadedBefore) / 1024 << " KB, saved "
+                      << (cache.bytesSaved - savedBefore) / 1024 << " KB, " << ms << " ms\n";
+        }
+        std::cout << "overall hit rate " << 100.0 * cache.hitRate() << "%, " << cache.bytesSaved / (1024 * 1024)
+                  << " MB not transferred\n";
+    }
+    std::filesystem::remove_all(dir);
+}
+
+
+
+// 📌 Step 11: Main Function to Run the Scraper
 // We define a set of URLs and scrape them concurrently.
+// Run with --bench [numUrls] to benchmark against the local server instead.
 
 // 🖥️ Code: Main Function
 
-int main() {
+int main(int argc, char* argv[]) {
+    curl_global_init(CURL_GLOBAL_DEFAULT); // Must run before any threads use cURL
+
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        size_t numUrls = argc > 2 ? std::stoul(argv[2]) : 2000;
+        runScraperBenchmark(numUrls, 16 * 1024);
+        runStreamingBenchmark(32, 8 * 1024 * 1024, 8);
+        runCrawlBenchmark(4, 500, 200);
+        runCacheBenchmark(1000, 64 * 1024, 3);
+        curl_global_cleanup();
+        return 0;
+    }
+
     std::vector<std::string> websites = {
         "https://www.example.com",
         "https://www.wikipedia.org",
@@ -93,17 +1731,43 @@ int main() {
     std::cout << "Starting concurrent web scraping...\n";
     scrapeWebsites(websites);
 
+    curl_global_cleanup();
     return 0;
 }
 
 
-📌 Step 5: Expected Output
+// 📌 Step 12: Expected Output
 
 // Starting concurrent web scraping...
 // Fetched https://www.example.com (12500 bytes)
 // Fetched https://www.wikipedia.org (40500 bytes)
 // Fetched https://www.github.com (32000 bytes)
 
+// With --bench 2000 (numbers from a 1-core Linux VM; yours will differ):
+// Benchmark: 2000 URLs, 16384 bytes per page, local server at http://127.0.0.1:39227/
+// std::async per URL              : 2000 pages in 967.717 ms (2066 pages/sec)
+// 8 workers, new handle per URL   : 2000 pages in 130.24 ms (15356 pages/sec)
+// 8 workers, pooled handles       : 2000 pages in 46.2423 ms (43250 pages/sec)
+// multi: 1 loop(s), 64 in flight  : 2000 pages in 60.9955 ms (32789 pages/sec)
+// ...
+//
+// Streaming benchmark: 32 pages of 8 MB, 8 in flight
+//   streaming found 3774592 links
+// buffered std::string   : peak RSS +81 MB, 452 MB/s
+// streaming HtmlLinkSink : peak RSS +1 MB, 120 MB/s (incl. link extraction)
+//
+// Crawl benchmark: 4 sites x 500 pages, 200 req/s per host
+// crawled 2000 pages (0 failed) from 4 hosts in 2.47655 s
+// links found: 18000, duplicates skipped: 16001, dropped: 0
+// per-host rate: 201.894 req/s (limit 200 + burst 10)
+// seen set: 1170 KB for 1000000 URLs (114 MB for 100M)
+//
+// Cache benchmark: 1000 pages of 64 KB, 3 rounds, cache in /tmp/scraper-cache-677
+// round 1: hit rate 0%, downloaded 64000 KB, saved 0 KB, 411.165 ms
+// round 2: hit rate 90%, downloaded 6400 KB, saved 57600 KB, 206.186 ms
+// round 3: hit rate 90%, downloaded 6400 KB, saved 57600 KB, 218.823 ms
+// overall hit rate 60%, 112 MB not transferred
+
 
 
 // 📌 Enhancements
@@ -116,4 +1780,4 @@ int main() {
 // Demonstrates real-world use of std::async & std::future.
 // Parallel processing speeds up web data retrieval.
 // Highly relevant in data collection, web scraping, and automation.
-// Impresses interviewers with advanced C++ concurrency concepts.
\ No newline at end of file
+// Impresses interviewers with advanced C++ concurrency concepts.
\ No newline at end of file
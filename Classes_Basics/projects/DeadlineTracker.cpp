@@ -5,6 +5,26 @@
 #include <optional>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <malloc.h>
+#include "FastOutput.h"
+// POSIX file I/O and mmap for the snapshot and the append log
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Task structure with optional deadline
 struct Task {
@@ -14,43 +34,1016 @@ struct Task {
     Task(std::string t, std::optional<std::string> d = std::nullopt)
         : title(std::move(t)), deadline(std::move(d)) {}
 };
+
+// Days since 1970-01-01 for a YYYY-MM-DD date. Invalid dates are rejected (std::invalid_argument).
+int parseDayNumber(std::string_view date) {
+    auto invalid = [&date]() { return std::invalid_argument("Invalid deadline: " + std::string(date)); };
+    auto digits = [&date, &invalid](size_t pos, size_t len) {
+        int value = 0;
+        for (size_t i = pos; i < pos + len; ++i) {
+            if (date[i] < '0' || date[i] > '9') throw invalid();
+            value = value * 10 + (date[i] - '0');
+        }
+        return value;
+    };
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') throw invalid();
+    int year = digits(0, 4), month = digits(5, 2), day = digits(8, 2);
+
+    static const int daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || day < 1 || day > daysInMonth[month - 1] + (month == 2 && leap)) throw invalid();
+
+    // Days from civil date (March-based year, so the leap day is the last day of the year)
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;  // Rounded down: January and February of 0000 are year -1
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Inverse of parseDayNumber: writes a day number as YYYY-MM-DD (10 characters, no terminator)
+void writeDayNumber(int dayNumber, char* out) {
+    int z = dayNumber + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;  // Rounded down, for the days before 0000-03-01
+    int dayOfEra = z - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int mp = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int month = mp < 10 ? mp + 3 : mp - 9;
+    int year = yearOfEra + era * 400 + (month <= 2);  // 0-9999 for any day parseDayNumber returns
+
+    auto twoDigits = [](char* at, int value) {
+        at[0] = static_cast<char>('0' + value / 10);
+        at[1] = static_cast<char>('0' + value % 10);
+    };
+    twoDigits(out, year / 100);
+    twoDigits(out + 2, year % 100);
+    out[4] = '-';
+    twoDigits(out + 5, month);
+    out[7] = '-';
+    twoDigits(out + 8, day);
+}
+
+std::string formatDayNumber(int dayNumber) {
+    char buf[10];
+    writeDayNumber(dayNumber, buf);
+    return std::string(buf, sizeof(buf));
+}
+
+const int kNoDeadlineDay = INT32_MIN;  // Day-number sentinel for "no deadline"
+
+// Strings stored back to back in one buffer and referred to by 32-bit offset and length
+class StringArena {
+    private:
+        std::string chars;
+
+    public:
+        struct Ref {
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        Ref add(std::string_view s) {
+            if (s.size() > UINT32_MAX - chars.size()) throw std::length_error("String arena is full (4 GB)");
+            Ref ref{static_cast<uint32_t>(chars.size()), static_cast<uint32_t>(s.size())};
+            chars.append(s);
+            return ref;
+        }
+
+        std::string_view view(Ref ref) const {
+            return std::string_view(chars.data() + ref.offset, ref.length);
+        }
+
+        size_t bytes() const {
+            return chars.size();
+        }
+
+        void clear() {
+            chars.clear();
+        }
+    };
+
+// How TaskManager stores a task: 12 bytes instead of a std::string and a std::optional<std::string>
+// (72 bytes on 64-bit libstdc++, plus a heap block for titles longer than 15 characters)
+struct CompactTask {
+    StringArena::Ref title;  // In TaskManager's title arena
+    int deadlineDay;         // parseDayNumber of the deadline, or kNoDeadlineDay
+};
+
+static_assert(sizeof(CompactTask) == 12, "CompactTask should stay three words");
 //Step 2: Function to Display Task Details
 //Code: Display Task Function
 
-void displayTask(const Task& task) {
-    std::cout << "Task: " << task.title << "\n";
-    if (task.deadline) {
-        std::cout << "  Deadline: " << task.deadline.value() << "\n";
+void displayTask(std::string_view title, std::optional<std::string_view> deadline) {
+    std::cout << "Task: " << title << "\n";
+    if (deadline) {
+        std::cout << "  Deadline: " << deadline.value() << "\n";
     } else {
         std::cout << "  Deadline: No Deadline Assigned\n";
     }
     std::cout << "----------------------\n";
 }
 
-//Step 3: TaskManager Class to Manage Tasks
+void displayTask(const Task& task) {
+    displayTask(task.title, task.deadline ? std::optional<std::string_view>(*task.deadline) : std::nullopt);
+}
+
+// Same text as above, into an OutputBuffer (see FastOutput.h), for listing many tasks
+void displayTask(OutputBuffer& out, std::string_view title, int deadlineDay) {
+    out << "Task: " << title << "\n";
+    if (deadlineDay == kNoDeadlineDay) {
+        out << "  Deadline: No Deadline Assigned\n";
+    } else {
+        char date[10];
+        writeDayNumber(deadlineDay, date);
+        out << "  Deadline: " << std::string_view(date, sizeof(date)) << "\n";
+    }
+    out << "----------------------\n";
+}
+
+//Step 3: Binary Snapshot and Append Log
+// Rebuilding tasks from text on every start is slow. A snapshot stores all tasks in one binary file
+// that is mmap()ed and read in place: records hold a title offset into a string section and the
+// deadline as a day number, so opening it does not depend on the number of tasks. Tasks added after
+// the snapshot go to an append-only log that is replayed on startup; checkpoint() folds them into a
+// new snapshot and starts an empty log.
+// Logs are numbered (generations). A snapshot records the first generation it does not contain, so
+// a log left over from an interrupted checkpoint is recognized as already folded in and is not
+// replayed twice.
+// Snapshot layout (native byte order): SnapshotHeader | SnapshotRecord[taskCount] | string bytes
+// Log layout: LogHeader | records
+// Log record: payload length (4) | checksum (4) | title length (4) | title | deadline day (4)
+//Code: Snapshot and Log
+
+class MappedFile {
+    private:
+        const char* bytes = nullptr;
+        size_t length = 0;
+
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open " + path);
+
+            struct stat info{};
+            fstat(fd, &info);
+            length = static_cast<size_t>(info.st_size);
+            if (length > 0) {
+                void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("Could not map " + path);
+                }
+                bytes = static_cast<const char*>(mapped);
+            }
+            close(fd); // The mapping stays valid without the descriptor
+        }
+
+        ~MappedFile() {
+            if (bytes) munmap(const_cast<char*>(bytes), length);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+    };
+
+// Makes temp the file at path. Its data is forced to disk before the rename and the directory entry
+// after it, so even after a power loss path holds either the old file or the complete new one.
+void renameDurably(const std::string& temp, const std::string& path) {
+    auto syncPath = [](const std::string& p) {
+        int fd = open(p.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open " + p);
+        int result = fsync(fd);
+        close(fd);
+        if (result != 0) throw std::runtime_error("Could not sync " + p);
+    };
+    syncPath(temp);
+    std::filesystem::rename(temp, path);
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    syncPath(dir.empty() ? "." : dir);
+}
+
+struct SnapshotHeader {
+    char magic[8];          // "DLTRSNAP"
+    uint32_t version;
+    uint32_t taskCount;
+    uint64_t stringsOffset; // Start of the string section
+    uint64_t stringsSize;
+    uint64_t logGeneration; // Logs of this generation and later hold tasks the snapshot does not
+};
+
+struct SnapshotRecord {
+    uint64_t titleOffset;   // Relative to the string section
+    uint32_t titleLength;
+    int32_t deadlineDay;    // kNoDeadlineDay if the task has none
+};
+
+const char kSnapshotMagic[8] = {'D', 'L', 'T', 'R', 'S', 'N', 'A', 'P'};
+const uint32_t kSnapshotVersion = 3;  // 2: deadlines as day numbers instead of strings, 3: log generation
+
+struct LogHeader {
+    char magic[8];          // "DLTRLOG1"
+    uint64_t generation;
+};
+
+const char kLogMagic[8] = {'D', 'L', 'T', 'R', 'L', 'O', 'G', '1'};
+
+// Collects tasks and writes them as one snapshot file
+class SnapshotWriter {
+    private:
+        std::vector<SnapshotRecord> records;
+        std::string strings;
+
+    public:
+        void add(std::string_view title, int deadlineDay) {
+            if (title.size() > UINT32_MAX) throw std::length_error("Task title too long for a snapshot");
+            records.push_back({strings.size(), static_cast<uint32_t>(title.size()), deadlineDay});
+            strings.append(title);
+        }
+
+        // Writes to a temporary file and renames it, so readers never see a half-written snapshot.
+        // logGeneration is the first log generation whose tasks are not in this snapshot.
+        void write(const std::string& path, uint64_t logGeneration) const {
+            if (records.size() > UINT32_MAX) throw std::length_error("Too many tasks for a snapshot");
+            SnapshotHeader header{};
+            std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+            header.version = kSnapshotVersion;
+            header.taskCount = static_cast<uint32_t>(records.size());
+            header.stringsOffset = sizeof(SnapshotHeader) + records.size() * sizeof(SnapshotRecord);
+            header.stringsSize = strings.size();
+            header.logGeneration = logGeneration;
+
+            std::string temp = path + ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SnapshotRecord));
+                out.write(strings.data(), strings.size());
+                if (!out.flush()) throw std::runtime_error("Could not write " + temp);
+            }
+            renameDurably(temp, path);
+        }
+    };
+
+// Read-only view of a snapshot file; tasks are read straight from the mapping without copying
+class TaskSnapshot {
+    private:
+        MappedFile file;
+        const SnapshotHeader* header = nullptr;
+        const SnapshotRecord* records = nullptr;
+        const char* strings = nullptr;
+
+        std::string_view text(uint64_t offset, uint32_t length) const {
+            if (offset > header->stringsSize || length > header->stringsSize - offset) {
+                throw std::runtime_error("Corrupt snapshot record");
+            }
+            return std::string_view(strings + offset, length);
+        }
+
+    public:
+        // Checks the header and section bounds only, so opening costs the same for any task count
+        explicit TaskSnapshot(const std::string& path) : file(path) {
+            if (file.size() < sizeof(SnapshotHeader)) throw std::runtime_error(path + " is not a task snapshot");
+            header = reinterpret_cast<const SnapshotHeader*>(file.data());
+            if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+                header->version != kSnapshotVersion) {
+                throw std::runtime_error(path + " is not a task snapshot");
+            }
+            uint64_t recordsEnd = sizeof(SnapshotHeader) + uint64_t(header->taskCount) * sizeof(SnapshotRecord);
+            if (header->stringsOffset < recordsEnd || header->stringsOffset > file.size() ||
+                header->stringsSize > file.size() - header->stringsOffset) {
+                throw std::runtime_error(path + " is truncated");
+            }
+            records = reinterpret_cast<const SnapshotRecord*>(file.data() + sizeof(SnapshotHeader));
+            strings = file.data() + header->stringsOffset;
+        }
+
+        size_t size() const {
+            return header->taskCount;
+        }
+
+        std::string_view title(size_t i) const {
+            return text(records[i].titleOffset, records[i].titleLength);
+        }
+
+        int deadlineDay(size_t i) const {
+            return records[i].deadlineDay;
+        }
+
+        uint64_t logGeneration() const {
+            return header->logGeneration;
+        }
+    };
+
+// Append-only log of tasks added since the last snapshot
+class TaskLog {
+    private:
+        int fd = -1;
+        std::string path;
+        uint64_t logGeneration;
+
+        static uint32_t checksum(const char* data, size_t size) {
+            uint32_t hash = 2166136261u; // FNV-1a
+            for (size_t i = 0; i < size; ++i) hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+            return hash;
+        }
+
+        template <typename T>
+        static void put(std::string& out, T value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        // Replaces the file with an empty log of this generation. Written aside and renamed, so a crash
+        // leaves either the old log or the new one.
+        void startFile(uint64_t generation) {
+            LogHeader header{};
+            std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+            header.generation = generation;
+            std::string temp = path + ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                if (!out.flush()) throw std::runtime_error("Could not write " + temp);
+            }
+            renameDurably(temp, path);
+
+            if (fd >= 0) close(fd);
+            fd = open(path.c_str(), O_WRONLY | O_APPEND);
+            if (fd < 0) throw std::runtime_error("Could not open log " + path);
+        }
+
+    public:
+        // Appends to the log at logPath if it has this generation; otherwise starts an empty one
+        TaskLog(std::string logPath, uint64_t generation) : path(std::move(logPath)), logGeneration(generation) {
+            if (generationOf(path) == generation) {
+                fd = open(path.c_str(), O_WRONLY | O_APPEND);
+                if (fd < 0) throw std::runtime_error("Could not open log " + path);
+            } else {
+                startFile(generation);
+            }
+        }
+
+        ~TaskLog() {
+            if (fd >= 0) close(fd);
+        }
+
+        TaskLog(const TaskLog&) = delete;
+        TaskLog& operator=(const TaskLog&) = delete;
+
+        // One write() per record; the record survives a crash of this process (call sync() for power loss)
+        void append(std::string_view title, int deadlineDay) {
+            std::string record(8, '\0');
+            put(record, static_cast<uint32_t>(title.size()));
+            record += title;
+            put(record, static_cast<int32_t>(deadlineDay));
+            uint32_t header[2] = {static_cast<uint32_t>(record.size() - 8), checksum(record.data() + 8, record.size() - 8)};
+            std::memcpy(&record[0], header, sizeof(header));
+
+            for (size_t written = 0; written < record.size();) {
+                ssize_t n = ::write(fd, record.data() + written, record.size() - written);
+                if (n < 0) throw std::runtime_error("Could not append to " + path);
+                written += static_cast<size_t>(n);
+            }
+        }
+
+        void sync() {
+            if (fdatasync(fd) != 0) throw std::runtime_error("Could not sync " + path);
+        }
+
+        uint64_t generation() const {
+            return logGeneration;
+        }
+
+        // Empties the log and moves it to the next generation (see TaskManager::checkpoint)
+        void restart(uint64_t generation) {
+            startFile(generation);
+            logGeneration = generation;
+        }
+
+        // The generation in the log's header; nullopt if there is no log or it has no valid header
+        static std::optional<uint64_t> generationOf(const std::string& path) {
+            LogHeader header{};
+            std::ifstream in(path, std::ios::binary);
+            if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0) {
+                return std::nullopt;
+            }
+            return header.generation;
+        }
+
+        // Calls onTask(title, deadlineDay) for every complete record. A torn or corrupt tail (from a crash
+        // mid-append) ends the replay and is cut off, so later appends are not hidden behind it.
+        template <typename Fn>
+        static void replay(const std::string& path, Fn onTask) {
+            if (!generationOf(path)) return;
+
+            MappedFile file(path);
+            const char* data = file.data();
+            size_t size = file.size(), pos = sizeof(LogHeader);
+            auto read32 = [data](size_t at) {
+                uint32_t v;
+                std::memcpy(&v, data + at, sizeof(v));
+                return v;
+            };
+            while (size - pos >= 8) {
+                uint32_t length = read32(pos), sum = read32(pos + 4);
+                if (length > size - pos - 8 || length < 8 || checksum(data + pos + 8, length) != sum) break;
+                uint32_t titleLength = read32(pos + 8);
+                if (titleLength != length - 8) break;
+
+                int32_t deadlineDay;
+                std::memcpy(&deadlineDay, data + pos + 12 + titleLength, sizeof(deadlineDay));
+                onTask(std::string_view(data + pos + 12, titleLength), deadlineDay);
+                pos += 8 + length;
+            }
+            if (pos < size) std::filesystem::resize_file(path, pos);
+        }
+    };
+
+//Step 4: Deadline Timing Wheel
+// Fires a callback when a deadline day arrives. Dates are parsed once into day numbers. A hierarchical
+// timing wheel keeps pending deadlines in 4 levels of 64 day-slots each: level L holds deadlines that
+// share all but the low 6 * (L + 1) bits of their day with the current day, so insert and cancel are
+// O(1) slot list operations and each deadline moves down at most 3 times before it fires.
+// Tasks without a deadline are never put in the wheel.
+//Code: DeadlineWheel
+
+// Identifies one scheduled deadline; stays safe to cancel after it fired or was cancelled
+struct DeadlineHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+};
+
+class DeadlineWheel {
+    public:
+        // payload is whatever the caller scheduled (TaskManager uses the task id); day is the deadline
+        using ExpiryCallback = std::function<void(uint64_t payload, int day)>;
+
+    private:
+        static constexpr int kLevels = 4;
+        static constexpr int kSlotBits = 6;
+        static constexpr uint32_t kSlots = 1u << kSlotBits;
+        static constexpr uint16_t kOverdue = kLevels * kSlots;  // Extra list: deadlines at or before the current day
+        static constexpr int64_t kTickBias = 719528;           // Tick 0 is 0000-01-01, the earliest day parseDayNumber accepts
+
+        struct Node {
+            uint64_t payload;
+            uint32_t tick;
+            uint32_t pos;         // Position in its slot list
+            uint32_t generation;
+            uint16_t list;        // Slot list the node is on, kFree when unused
+        };
+        static constexpr uint16_t kFree = UINT16_MAX;
+
+        // Slot lists are vectors of node indices rather than linked lists: draining a slot then reads
+        // independent nodes, whose cache misses overlap, instead of chasing one pointer after another
+        std::vector<Node> nodes;
+        std::vector<uint32_t> freeNodes;
+        std::vector<uint32_t> lists[kLevels * kSlots + 1];
+        std::vector<uint32_t> draining;  // The list being emptied (keeps its capacity between days)
+        uint32_t now;  // Current tick (day + kTickBias)
+        size_t pending = 0;
+        ExpiryCallback onExpiry;
+        std::vector<std::pair<uint64_t, uint32_t>> firing;
+
+        void pushTo(uint16_t list, uint32_t index) {
+            nodes[index].list = list;
+            nodes[index].pos = static_cast<uint32_t>(lists[list].size());
+            lists[list].push_back(index);
+        }
+
+        // Swap-remove: the last node of the list takes the removed node's place
+        void unlink(uint32_t index) {
+            std::vector<uint32_t>& list = lists[nodes[index].list];
+            uint32_t last = list.back();
+            list[nodes[index].pos] = last;
+            nodes[last].pos = nodes[index].pos;
+            list.pop_back();
+        }
+
+        // Lowest level whose slot range covers the tick, given the current tick
+        uint16_t listFor(uint32_t tick) const {
+            if (tick <= now) return kOverdue;
+            for (int level = 0; level < kLevels; ++level) {
+                if ((tick ^ now) >> (kSlotBits * (level + 1)) == 0) {
+                    return static_cast<uint16_t>(level * kSlots + ((tick >> (kSlotBits * level)) & (kSlots - 1)));
+                }
+            }
+            return kOverdue;  // Unreachable: ticks are checked to fit in kLevels * kSlotBits bits
+        }
+
+        // Takes every node off a list, frees it and queues its callback
+        void collect(uint16_t list) {
+            draining.swap(lists[list]);
+            for (uint32_t index : draining) {
+                firing.emplace_back(nodes[index].payload, nodes[index].tick);
+                release(index);
+            }
+            draining.clear();
+        }
+
+        void release(uint32_t index) {
+            nodes[index].list = kFree;
+            ++nodes[index].generation;
+            freeNodes.push_back(index);
+            --pending;
+        }
+
+        void fire() {
+            for (const auto& [payload, tick] : firing) onExpiry(payload, static_cast<int>(int64_t(tick) - kTickBias));
+            firing.clear();
+        }
+
+    public:
+        // today is the current day number; deadlines on or before it fire at the next advanceTo
+        DeadlineWheel(int today, ExpiryCallback callback) : now(toTick(today)), onExpiry(std::move(callback)) {}
+
+        static uint32_t toTick(int day) {
+            int64_t tick = int64_t(day) + kTickBias;
+            if (tick < 0 || tick >= (int64_t(1) << (kLevels * kSlotBits))) throw std::out_of_range("Deadline out of range");
+            return static_cast<uint32_t>(tick);
+        }
+
+        DeadlineHandle schedule(int day, uint64_t payload) {
+            uint32_t tick = toTick(day);
+            uint32_t index;
+            if (!freeNodes.empty()) {
+                index = freeNodes.back();
+                freeNodes.pop_back();
+            } else {
+                if (nodes.size() >= UINT32_MAX) throw std::length_error("Too many pending deadlines");
+                index = static_cast<uint32_t>(nodes.size());
+                nodes.push_back(Node{0, 0, 0, 0, kFree});
+            }
+            nodes[index].payload = payload;
+            nodes[index].tick = tick;
+            pushTo(listFor(tick), index);
+            ++pending;
+            return DeadlineHandle{index, nodes[index].generation};
+        }
+
+        // False if the deadline already fired or was cancelled
+        bool cancel(DeadlineHandle handle) {
+            if (handle.index >= nodes.size()) return false;
+            Node& node = nodes[handle.index];
+            if (node.list == kFree || node.generation != handle.generation) return false;
+            unlink(handle.index);
+            release(handle.index);
+            return true;
+        }
+
+        // Moves the current day forward, firing every deadline up to and including today in day order.
+        // Callbacks may schedule and cancel, but must not call advanceTo.
+        void advanceTo(int today) {
+            uint32_t target = toTick(today);
+            collect(kOverdue);
+            fire();
+            while (now < target) {
+                ++now;
+                // Cascade: when the low bits of now wrap, the matching slot of each higher level moves down
+                for (int level = kLevels - 1; level > 0; --level) {
+                    if ((now & ((1u << (kSlotBits * level)) - 1)) != 0) continue;
+                    uint16_t list = static_cast<uint16_t>(level * kSlots + ((now >> (kSlotBits * level)) & (kSlots - 1)));
+                    draining.swap(lists[list]);
+                    for (uint32_t index : draining) pushTo(listFor(nodes[index].tick), index);
+                    draining.clear();
+                }
+                collect(static_cast<uint16_t>(now & (kSlots - 1)));
+                collect(kOverdue);  // Deadlines scheduled for today by callbacks
+                fire();
+            }
+        }
+
+        int today() const {
+            return static_cast<int>(int64_t(now) - kTickBias);
+        }
+
+        size_t size() const {
+            return pending;
+        }
+    };
+
+//Step 5: TaskManager Class to Manage Tasks
 //Code: TaskManager Class
 
 class TaskManager {
     private:
-        std::vector<Task> tasks;
-    
+        // Tasks as CompactTask, titles in one arena. With openStorage: tasks from the last snapshot
+        // stay in the mapping and these hold only the newer ones.
+        std::vector<CompactTask> tasks;
+        StringArena titles;
+        std::unique_ptr<TaskSnapshot> snapshot;
+        std::unique_ptr<TaskLog> log;
+        std::string snapshotPath;
+        // With enableDeadlineAlerts: the wheel, and each task's handle by task id
+        std::unique_ptr<DeadlineWheel> wheel;
+        std::vector<DeadlineHandle> deadlineHandles;
+
+        // The handle's slot is added first, so handles stay indexed by task id even if schedule throws
+        void scheduleDeadline(size_t id, int deadlineDay) {
+            deadlineHandles.emplace_back();
+            if (deadlineDay != kNoDeadlineDay) deadlineHandles.back() = wheel->schedule(deadlineDay, id);
+        }
+
+        void store(std::string_view title, int deadlineDay) {
+            tasks.push_back({titles.add(title), deadlineDay});
+            if (wheel) scheduleDeadline(size() - 1, deadlineDay);
+        }
+
     public:
+        // Task ids are positions in showAllTasks order: snapshot tasks first, then newer ones.
+        // The deadline is parsed here, once: throws std::invalid_argument unless it is a valid YYYY-MM-DD.
         void addTask(const Task& task) {
-            tasks.push_back(task);
+            int deadlineDay = task.deadline ? parseDayNumber(*task.deadline) : kNoDeadlineDay;
+            if (log) log->append(task.title, deadlineDay);
+            store(task.title, deadlineDay);
         }
-    
-        void showAllTasks() const {
-            for (const auto& task : tasks) {
-                displayTask(task);
+
+        std::string_view title(size_t id) const {
+            size_t stored = snapshot ? snapshot->size() : 0;
+            return id < stored ? snapshot->title(id) : titles.view(tasks.at(id - stored).title);
+        }
+
+        // kNoDeadlineDay if the task has no deadline
+        int deadlineDay(size_t id) const {
+            size_t stored = snapshot ? snapshot->size() : 0;
+            return id < stored ? snapshot->deadlineDay(id) : tasks.at(id - stored).deadlineDay;
+        }
+
+        // Calls fn(title, deadlineDay) for every task in id order
+        template <typename Fn>
+        void forEachTask(Fn fn) const {
+            if (snapshot) {
+                for (size_t i = 0; i < snapshot->size(); ++i) fn(snapshot->title(i), snapshot->deadlineDay(i));
+            }
+            for (const CompactTask& task : tasks) fn(titles.view(task.title), task.deadlineDay);
+        }
+
+        // Calls onDeadline(taskId, day) once a task's deadline day is reached (see advanceTo).
+        // Schedules every current task with a deadline.
+        void enableDeadlineAlerts(std::string_view today, std::function<void(size_t taskId, int day)> onDeadline) {
+            wheel = std::make_unique<DeadlineWheel>(parseDayNumber(today), [onDeadline](uint64_t id, int day) {
+                onDeadline(static_cast<size_t>(id), day);
+            });
+            deadlineHandles.clear();
+            deadlineHandles.reserve(size());
+            try {
+                forEachTask([this](std::string_view, int deadlineDay) { scheduleDeadline(deadlineHandles.size(), deadlineDay); });
+            } catch (...) {
+                // Alerts for only some of the tasks would be worse than none
+                wheel.reset();
+                deadlineHandles.clear();
+                throw;
+            }
+        }
+
+        // Fires the alerts of every deadline up to and including today
+        void advanceTo(std::string_view today) {
+            if (!wheel) throw std::logic_error("advanceTo() needs enableDeadlineAlerts()");
+            wheel->advanceTo(parseDayNumber(today));
+        }
+
+        // Cancels the task's pending alert; false if it had none or it already fired
+        bool completeTask(size_t id) {
+            return wheel && id < deadlineHandles.size() && wheel->cancel(deadlineHandles[id]);
+        }
+
+        // Maps the snapshot (if there is one), replays the log and logs every later addTask.
+        // Task ids start over, so deadline alerts are switched off.
+        void openStorage(const std::string& snapshotFile, const std::string& logFile) {
+            wheel.reset();
+            deadlineHandles.clear();
+            snapshotPath = snapshotFile;
+            snapshot.reset();
+            if (std::filesystem::exists(snapshotPath)) snapshot = std::make_unique<TaskSnapshot>(snapshotPath);
+            tasks.clear();
+            titles.clear();
+            // A log older than the snapshot is one a checkpoint already folded in before it was interrupted
+            uint64_t generation = snapshot ? snapshot->logGeneration() : 0;
+            std::optional<uint64_t> logGeneration = TaskLog::generationOf(logFile);
+            if (logGeneration && *logGeneration >= generation) {
+                TaskLog::replay(logFile, [this](std::string_view title, int deadlineDay) { store(title, deadlineDay); });
+                generation = *logGeneration;
             }
+            log = std::make_unique<TaskLog>(logFile, generation);
+        }
+
+        // Writes all tasks into a new snapshot and starts an empty log. The snapshot is renamed into place
+        // first, marked as holding this log's generation; a crash or power loss before the log restarts
+        // leaves a log openStorage skips.
+        void checkpoint() {
+            if (!log) throw std::logic_error("checkpoint() needs openStorage()");
+            SnapshotWriter writer;
+            forEachTask([&writer](std::string_view title, int deadlineDay) { writer.add(title, deadlineDay); });
+            uint64_t next = log->generation() + 1;
+            writer.write(snapshotPath, next);
+            snapshot = std::make_unique<TaskSnapshot>(snapshotPath);
+            tasks.clear();
+            titles.clear();
+            log->restart(next);
+        }
+
+        // addTask survives a crash of this process; after sync() the tasks added so far also survive a power loss
+        void sync() {
+            if (!log) throw std::logic_error("sync() needs openStorage()");
+            log->sync();
+        }
+
+        size_t size() const {
+            return (snapshot ? snapshot->size() : 0) + tasks.size();
+        }
+
+        void showAllTasks() const {
+            exportTasks(OutputFormat::Text);
+        }
+
+        // Writes every task to fd as text (like showAllTasks), JSON lines
+        // ({"id":0,"title":"...","deadline":"2025-03-10"}, deadline null if none) or CSV (id,title,deadline).
+        // Returns the number of bytes written.
+        size_t exportTasks(OutputFormat format, int fd = STDOUT_FILENO) const {
+            OutputBuffer out(fd);
+            size_t id = 0;
+            char date[10];
+            if (format == OutputFormat::Csv) out << "id,title,deadline\n";
+            forEachTask([&](std::string_view title, int deadlineDay) {
+                switch (format) {
+                    case OutputFormat::Text:
+                        displayTask(out, title, deadlineDay);
+                        break;
+                    case OutputFormat::JsonLines:
+                        out << "{\"id\":" << id << ",\"title\":";
+                        out.jsonString(title) << ",\"deadline\":";
+                        if (deadlineDay == kNoDeadlineDay) {
+                            out << "null";
+                        } else {
+                            writeDayNumber(deadlineDay, date);
+                            out << '"' << std::string_view(date, sizeof(date)) << '"';
+                        }
+                        out << "}\n";
+                        break;
+                    case OutputFormat::Csv:
+                        out << id << ',';
+                        out.csvField(title) << ',';
+                        if (deadlineDay != kNoDeadlineDay) {
+                            writeDayNumber(deadlineDay, date);
+                            out << std::string_view(date, sizeof(date));
+                        }
+                        out << '\n';
+                        break;
+                }
+                ++id;
+            });
+            out.flush();
+            return out.bytesWritten();
         }
     };
     
 
-//Step 4: Main Function to Test the TaskManager
+
+//Step 6: Benchmarks: Startup from Text vs. Snapshot, Deadline Wheel, Footprint, Output
+// Rebuilding N tasks by parsing a text file (what we did on every start) against opening a snapshot,
+// plus the cost of logging new tasks and replaying the log.
+//Code: Benchmark
+
+void runStorageBenchmark(size_t numTasks) {
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / ("deadline-tracker-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    std::string textPath = (dir / "tasks.txt").string();
+    std::string snapshotPath = (dir / "tasks.snap").string();
+    std::string logPath = (dir / "tasks.log").string();
+
+    {
+        std::ofstream text(textPath);
+        for (size_t i = 0; i < numTasks; ++i) {
+            text << "Task number " << i << "|";
+            if (i % 3 != 0) text << "2025-" << (i % 12 + 1 < 10 ? "0" : "") << i % 12 + 1 << "-15";
+            text << "\n";
+        }
+    }
+    std::cout << "Benchmark: " << numTasks << " tasks\n";
+
+    auto loadText = [&textPath](TaskManager& manager) {
+        std::ifstream text(textPath);
+        std::string line;
+        while (std::getline(text, line)) {
+            size_t bar = line.find('|');
+            std::optional<std::string> deadline;
+            if (bar + 1 < line.size()) deadline = line.substr(bar + 1);
+            manager.addTask(Task(line.substr(0, bar), std::move(deadline)));
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        TaskManager fromText;
+        loadText(fromText);
+        std::cout << "rebuild from text       : " << elapsedMs(start) << " ms\n";
+    }
+
+    {
+        TaskManager logged;
+        logged.openStorage(snapshotPath, logPath);
+        start = std::chrono::steady_clock::now();
+        loadText(logged);
+        std::cout << "addTask with log        : " << elapsedMs(start) << " ms\n";
+        start = std::chrono::steady_clock::now();
+        logged.sync();
+        std::cout << "sync log                : " << elapsedMs(start) << " ms\n";
+    }
+
+    start = std::chrono::steady_clock::now();
+    TaskManager replayed;
+    replayed.openStorage(snapshotPath, logPath);
+    std::cout << "open, replay log        : " << elapsedMs(start) << " ms (" << replayed.size() << " tasks)\n";
+
+    start = std::chrono::steady_clock::now();
+    replayed.checkpoint();
+    std::cout << "checkpoint              : " << elapsedMs(start) << " ms, snapshot "
+              << std::filesystem::file_size(snapshotPath) / 1024 << " KB\n";
+
+    start = std::chrono::steady_clock::now();
+    TaskManager opened;
+    opened.openStorage(snapshotPath, logPath);
+    std::cout << "open snapshot (mmap)    : " << elapsedMs(start) << " ms (" << opened.size() << " tasks)\n";
+
+    std::filesystem::remove_all(dir);
+}
+// Timing wheel throughput: schedule numDeadlines deadlines spread over three years, cancel every
+// other one, then advance day by day until all have fired. A std::multimap keyed by day, erased
+// through saved iterators, is the comparison.
+void runWheelBenchmark(size_t numDeadlines) {
+    auto mops = [numDeadlines](std::chrono::steady_clock::time_point start, size_t ops) {
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return ops / seconds / 1e6;
+    };
+    const int today = parseDayNumber("2025-01-01");
+    const int horizon = 3 * 365;
+    std::mt19937 rng(11);
+    std::vector<int> days(numDeadlines);
+    for (int& day : days) day = today + 1 + static_cast<int>(rng() % horizon);
+    std::cout << "\nDeadline benchmark: " << numDeadlines << " deadlines over " << horizon
+              << " days, half cancelled (M ops/s)\n";
+
+    size_t fired = 0;
+    {
+        DeadlineWheel wheel(today, [&fired](uint64_t, int) { ++fired; });
+        std::vector<DeadlineHandle> handles(numDeadlines);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numDeadlines; ++i) handles[i] = wheel.schedule(days[i], i);
+        double insert = mops(start, numDeadlines);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numDeadlines; i += 2) wheel.cancel(handles[i]);
+        double cancel = mops(start, numDeadlines / 2);
+        size_t pending = wheel.size();
+        start = std::chrono::steady_clock::now();
+        for (int day = today + 1; day <= today + horizon; ++day) wheel.advanceTo(day);
+        std::cout << "DeadlineWheel       : insert " << insert << ", cancel " << cancel << ", expire "
+                  << mops(start, pending) << "\n";
+    }
+    {
+        std::multimap<int, uint64_t> timers;
+        std::vector<std::multimap<int, uint64_t>::iterator> handles(numDeadlines);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numDeadlines; ++i) handles[i] = timers.emplace(days[i], i);
+        double insert = mops(start, numDeadlines);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numDeadlines; i += 2) timers.erase(handles[i]);
+        double cancel = mops(start, numDeadlines / 2);
+        size_t pending = timers.size();
+        start = std::chrono::steady_clock::now();
+        for (int day = today + 1; day <= today + horizon; ++day) {
+            while (!timers.empty() && timers.begin()->first <= day) {
+                ++fired;
+                timers.erase(timers.begin());
+            }
+        }
+        std::cout << "std::multimap       : insert " << insert << ", cancel " << cancel << ", expire "
+                  << mops(start, pending) << "\n";
+    }
+    std::cout << "(" << fired << " fired)\n";
+}
+// Task footprint: a vector of Task (std::string title, std::optional<std::string> deadline) against
+// TaskManager's CompactTask and title arena. Memory is the heap in use (glibc mallinfo2, including
+// spare vector capacity) per task;
+// iteration counts the tasks due before a date and sums title lengths.
+void runFootprintBenchmark(size_t numTasks) {
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    auto heapInUse = []() {
+        struct mallinfo2 info = mallinfo2();
+        return info.uordblks + info.hblkhd;  // Large blocks (the vectors, the arena) are mmap()ed separately
+    };
+    auto deadlineOf = [](size_t i) -> std::optional<std::string> {
+        if (i % 3 == 0) return std::nullopt;
+        return formatDayNumber(parseDayNumber("2025-01-01") + static_cast<int>(i % 730));
+    };
+    const std::string cutoff = "2025-07-01";
+    std::cout << "\nFootprint benchmark: " << numTasks << " tasks, two thirds with a deadline\n";
+
+    size_t checksum = 0;
+    {
+        size_t before = heapInUse();
+        std::vector<Task> tasks;
+        tasks.reserve(numTasks);
+        for (size_t i = 0; i < numTasks; ++i) tasks.emplace_back("Task number " + std::to_string(i), deadlineOf(i));
+        size_t bytes = heapInUse() - before;
+
+        auto start = std::chrono::steady_clock::now();
+        size_t due = 0, titleBytes = 0;
+        for (const Task& task : tasks) {
+            due += task.deadline && *task.deadline < cutoff;
+            titleBytes += task.title.size();
+        }
+        std::cout << "Task (string, optional<string>): " << double(bytes) / numTasks << " bytes/task, iterate "
+                  << elapsedMs(start) << " ms\n";
+        checksum += due + titleBytes;
+    }
+    {
+        size_t before = heapInUse();
+        TaskManager manager;
+        for (size_t i = 0; i < numTasks; ++i) manager.addTask(Task("Task number " + std::to_string(i), deadlineOf(i)));
+        size_t bytes = heapInUse() - before;
+
+        auto start = std::chrono::steady_clock::now();
+        int cutoffDay = parseDayNumber(cutoff);
+        size_t due = 0, titleBytes = 0;
+        manager.forEachTask([&](std::string_view title, int deadlineDay) {
+            due += deadlineDay != kNoDeadlineDay && deadlineDay < cutoffDay;
+            titleBytes += title.size();
+        });
+        std::cout << "CompactTask + title arena      : " << double(bytes) / numTasks << " bytes/task, iterate "
+                  << elapsedMs(start) << " ms\n";
+        checksum += due + titleBytes;
+    }
+    std::cout << "(checksum " << checksum << ")\n";
+}
+// Listing all tasks: the std::cout path (displayTask field by field, as showAllTasks did before)
+// against OutputBuffer text, JSON lines and CSV. stdout is pointed at /dev/null while timing.
+void runOutputBenchmark(size_t numTasks) {
+    TaskManager manager;
+    for (size_t i = 0; i < numTasks; ++i) {
+        manager.addTask(Task("Task number " + std::to_string(i),
+                             i % 3 == 0 ? std::nullopt : std::optional<std::string>(formatDayNumber(20000 + int(i % 730)))));
+    }
+    auto toDevNull = [](auto write) {
+        std::cout.flush();
+        int console = dup(STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        close(devNull);
+        auto start = std::chrono::steady_clock::now();
+        size_t bytes = write();
+        std::cout.flush();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        dup2(console, STDOUT_FILENO);
+        close(console);
+        return std::make_pair(bytes, seconds);
+    };
+    auto report = [](const char* label, std::pair<size_t, double> result) {
+        std::cout << label << result.first / result.second / 1e6 << " MB/s (" << result.first / 1000000 << " MB)\n";
+    };
+    std::cout << "\nOutput benchmark: " << numTasks << " tasks to /dev/null\n";
+
+    // Same text either way, so the cout path is credited with the bytes the text export wrote
+    auto text = toDevNull([&manager] { return manager.exportTasks(OutputFormat::Text); });
+    size_t textBytes = text.first;
+    report("std::cout displayTask   : ", toDevNull([&manager, textBytes] {
+        manager.forEachTask([](std::string_view title, int deadlineDay) {
+            if (deadlineDay == kNoDeadlineDay) displayTask(title, std::nullopt);
+            else displayTask(title, formatDayNumber(deadlineDay));
+        });
+        return textBytes;
+    }));
+    report("OutputBuffer text       : ", text);
+    report("OutputBuffer JSON lines : ", toDevNull([&manager] { return manager.exportTasks(OutputFormat::JsonLines); }));
+    report("OutputBuffer CSV        : ", toDevNull([&manager] { return manager.exportTasks(OutputFormat::Csv); }));
+}
+
+
+//Step 7: Main Function to Test the TaskManager
 //Code: Main Function
+// Run with --bench [numTasks] to compare startup from text with startup from a snapshot, and the
+// timing wheel with a std::multimap, the task footprint at 10 x numTasks, and output throughput.
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        size_t numTasks = argc > 2 ? std::stoul(argv[2]) : 1000000;
+        runStorageBenchmark(numTasks);
+        runWheelBenchmark(numTasks);
+        runFootprintBenchmark(10 * numTasks);
+        runOutputBenchmark(numTasks);
+        return 0;
+    }
 
-int main() {
     TaskManager manager;
 
     // Task with a deadline
@@ -65,6 +1058,12 @@ int main() {
     // Display all tasks
     manager.showAllTasks();
 
+    // Deadline alerts: move from March 1st to March 15th
+    manager.enableDeadlineAlerts("2025-03-01", [&manager](size_t id, int day) {
+        std::cout << "Deadline reached: " << manager.title(id) << " (" << formatDayNumber(day) << ")\n";
+    });
+    manager.advanceTo("2025-03-15");
+
     return 0;
 }
 
@@ -82,6 +1081,7 @@ int main() {
 // Task: Prepare for Tech Talk
 //   Deadline: 2025-04-01
 // ----------------------
+// Deadline reached: Submit AI Report (2025-03-10)
 
 //In this example, we defined a Task structure with an optional deadline field using std::optional. 
 // The TaskManager class manages tasks and allows adding tasks with or without deadlines. The displayTask function is used to print the details of each task, including the title and deadline (if present). The main function demonstrates adding tasks with and without deadlines and displaying all tasks using the TaskManager.
@@ -14,6 +14,10 @@
 #include <vector>
 #include <string>
 #include <ctime>
+#include <chrono>
+#include <utility>
+#include <fcntl.h>
+#include "FastOutput.h"
 
 // Function to get the current timestamp
 std::string getCurrentTime() {
@@ -28,6 +32,8 @@ using LogEntry = std::pair<std::string, std::string>;
 
 // 📌 Step 2: Logging System with std::vector<std::pair<>>
 // We store logs in a vector for easy retrieval.
+// showLogs and exportLogs write through OutputBuffer (FastOutput.h): one write(2) per 64 KB
+// instead of streaming every field through std::cout.
 
 // 🖥️ Code: Log System
 
@@ -41,21 +47,97 @@ class Logger {
         }
     
         void showLogs() const {
+            exportLogs(OutputFormat::Text);
+        }
+
+        // Writes every entry to fd as text ("[time] message", like showLogs), JSON lines
+        // ({"time":"...","message":"..."}) or CSV (time,message). Returns the number of bytes written.
+        size_t exportLogs(OutputFormat format, int fd = STDOUT_FILENO) const {
+            OutputBuffer out(fd);
+            if (format == OutputFormat::Csv) out << "time,message\n";
             for (const auto& entry : logs) {
-                std::cout << "[" << entry.first << "] " << entry.second << "\n";
+                switch (format) {
+                    case OutputFormat::Text:
+                        out << '[' << entry.first << "] " << entry.second << '\n';
+                        break;
+                    case OutputFormat::JsonLines:
+                        out << "{\"time\":";
+                        out.jsonString(entry.first) << ",\"message\":";
+                        out.jsonString(entry.second) << "}\n";
+                        break;
+                    case OutputFormat::Csv:
+                        out.csvField(entry.first) << ',';
+                        out.csvField(entry.second) << '\n';
+                        break;
+                }
             }
+            out.flush();
+            return out.bytesWritten();
+        }
+
+        const std::vector<LogEntry>& entries() const {
+            return logs;
         }
     };
     
 
-    // 📌 Step 3: Main Function to Test Logging System
+    // 📌 Step 3: Benchmark: Dumping Many Logs
+    // The old showLogs loop (std::cout, field by field) against OutputBuffer text, JSON lines and CSV,
+    // with stdout pointed at /dev/null while timing. Run with --bench [numEntries].
+
+    // 🖥️ Code: Benchmark
+
+    void runOutputBenchmark(size_t numEntries) {
+        Logger logger;
+        for (size_t i = 0; i < numEntries; ++i) {
+            logger.log("Memory allocation of " + std::to_string(i % 512 + 1) + " MB successful.");
+        }
+        auto toDevNull = [](auto write) {
+            std::cout.flush();
+            int console = dup(STDOUT_FILENO);
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+            auto start = std::chrono::steady_clock::now();
+            size_t bytes = write();
+            std::cout.flush();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            dup2(console, STDOUT_FILENO);
+            close(console);
+            return std::make_pair(bytes, seconds);
+        };
+        auto report = [](const char* label, std::pair<size_t, double> result) {
+            std::cout << label << result.first / result.second / 1e6 << " MB/s (" << result.first / 1000000 << " MB)\n";
+        };
+        std::cout << "Output benchmark: " << numEntries << " log entries to /dev/null\n";
+
+        // Same text either way, so the cout loop is credited with the bytes the text export wrote
+        auto text = toDevNull([&logger] { return logger.exportLogs(OutputFormat::Text); });
+        size_t textBytes = text.first;
+        report("std::cout loop          : ", toDevNull([&logger, textBytes] {
+            for (const auto& entry : logger.entries()) {
+                std::cout << "[" << entry.first << "] " << entry.second << "\n";
+            }
+            return textBytes;
+        }));
+        report("OutputBuffer text       : ", text);
+        report("OutputBuffer JSON lines : ", toDevNull([&logger] { return logger.exportLogs(OutputFormat::JsonLines); }));
+        report("OutputBuffer CSV        : ", toDevNull([&logger] { return logger.exportLogs(OutputFormat::Csv); }));
+    }
+
+    // 📌 Step 4: Main Function to Test Logging System
     // We log some memory operations and errors.
     
     // 🖥️ Code: Main Function
 
 
 
-    int main() {
+    int main(int argc, char* argv[]) {
+        if (argc > 1 && std::string(argv[1]) == "--bench") {
+            runOutputBenchmark(argc > 2 ? std::stoul(argv[2]) : 1000000);
+            return 0;
+        }
+
         Logger memoryLogger;
     
         memoryLogger.log("Memory allocation of 256 MB successful.");
@@ -69,7 +151,7 @@ class Logger {
         return 0;
     }
 
-    // 📌 Step 4: Expected Output
+    // 📌 Step 5: Expected Output
 
 
 //     Memory Logs:
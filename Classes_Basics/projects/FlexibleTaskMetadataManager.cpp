@@ -5,82 +5,1466 @@
 #include <unordered_map>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <typeinfo>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <chrono>
+#include <random>
+#include <optional>
+#include <type_traits>
+#include <stdexcept>
+#include <memory>
+#include <algorithm>
+#include <climits>
+#include <deque>
+#include <fstream>
+#include <filesystem>
+#include <malloc.h>
+// POSIX file I/O and mmap for the snapshot and the append log
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Metadata keys are interned: each distinct key name is stored once and tasks refer to it by a 32-bit id
+using MetadataKey = uint32_t;
+
+class MetadataKeyRegistry {
+private:
+    std::deque<std::string> names;  // A deque never moves its elements, so the views in ids stay valid
+    std::unordered_map<std::string_view, MetadataKey> ids;  // Looked up by string_view without allocating
+
+public:
+    // The registry shared by all tasks (not thread-safe, like the rest of this manager)
+    static MetadataKeyRegistry& global() {
+        static MetadataKeyRegistry registry;
+        return registry;
+    }
+
+    MetadataKey intern(std::string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        MetadataKey key = static_cast<MetadataKey>(names.size());
+        names.emplace_back(name);
+        ids.emplace(names.back(), key);
+        return key;
+    }
+
+    // Unlike intern, never adds the name
+    std::optional<MetadataKey> find(std::string_view name) const noexcept {
+        auto it = ids.find(name);
+        if (it == ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    const std::string& name(MetadataKey key) const {
+        return names.at(key);
+    }
+};
+
+// Point in time, stored as seconds since the Unix epoch (UTC)
+struct Timestamp {
+    int64_t secondsSinceEpoch;
+};
+
+// Tagged union for one metadata value in 16 bytes: an int, a double, a timestamp or a string.
+// Strings up to 14 bytes are stored inline; longer ones in one heap block.
+class MetadataValue {
+public:
+    enum class Type : uint8_t { Int, Double, String, Timestamp };
+
+    MetadataValue() : MetadataValue(int64_t(0)) {}
+    MetadataValue(int64_t v) : type(Type::Int) { store(v); }
+    MetadataValue(double v) : type(Type::Double) { store(v); }
+    MetadataValue(Timestamp v) : type(Type::Timestamp) { store(v.secondsSinceEpoch); }
+
+    MetadataValue(std::string_view s) : type(Type::String) {
+        if (s.size() <= kInlineCapacity) {
+            std::memcpy(bytes, s.data(), s.size());
+            inlineSize = static_cast<uint8_t>(s.size());
+        } else {
+            setHeapString(s);
+        }
+    }
+
+    MetadataValue(const MetadataValue& other) : inlineSize(other.inlineSize), type(other.type) {
+        if (other.isHeapString()) {
+            setHeapString(other.asString());
+        } else {
+            std::memcpy(bytes, other.bytes, sizeof(bytes));
+        }
+    }
+
+    MetadataValue(MetadataValue&& other) noexcept : inlineSize(other.inlineSize), type(other.type) {
+        std::memcpy(bytes, other.bytes, sizeof(bytes));  // Takes over the heap block, if any
+        other.type = Type::Int;
+        other.inlineSize = 0;
+    }
+
+    MetadataValue& operator=(MetadataValue other) noexcept {
+        std::swap(bytes, other.bytes);
+        std::swap(inlineSize, other.inlineSize);
+        std::swap(type, other.type);
+        return *this;
+    }
+
+    ~MetadataValue() {
+        if (isHeapString()) delete[] load<char*>(0);
+    }
+
+    Type getType() const { return type; }
+    int64_t asInt() const { return load<int64_t>(0); }
+    double asDouble() const { return load<double>(0); }
+    Timestamp asTimestamp() const { return Timestamp{load<int64_t>(0)}; }
+
+    std::string_view asString() const {
+        if (isHeapString()) return std::string_view(load<char*>(0), load<uint32_t>(8));
+        return std::string_view(reinterpret_cast<const char*>(bytes), inlineSize);
+    }
+
+private:
+    static constexpr size_t kInlineCapacity = 14;
+    static constexpr uint8_t kHeapString = 0xFF;  // inlineSize marker: bytes hold a pointer and a length
+
+    alignas(8) unsigned char bytes[kInlineCapacity];
+    uint8_t inlineSize = 0;
+    Type type;
+
+    bool isHeapString() const { return type == Type::String && inlineSize == kHeapString; }
+
+    template <typename T>
+    void store(T v, size_t offset = 0) {
+        std::memcpy(bytes + offset, &v, sizeof(T));
+    }
+
+    template <typename T>
+    T load(size_t offset) const {
+        T v;
+        std::memcpy(&v, bytes + offset, sizeof(T));
+        return v;
+    }
+
+    void setHeapString(std::string_view s) {
+        if (s.size() > UINT32_MAX) throw std::length_error("Metadata string too long");
+        char* data = new char[s.size()];
+        std::memcpy(data, s.data(), s.size());
+        store(data);
+        store(static_cast<uint32_t>(s.size()), 8);
+        inlineSize = kHeapString;
+    }
+};
+
+static_assert(sizeof(MetadataValue) == 16, "MetadataValue should stay two words");
+
+// Conversions between C++ types and MetadataValue: integers, floating point, strings and Timestamp
+template <typename T>
+constexpr bool kUnsupportedMetadataType = false;
+
+template <typename T>
+MetadataValue toMetadataValue(const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        static_assert(kUnsupportedMetadataType<T>, "Store flags as int");
+    } else if constexpr (std::is_integral_v<T>) {
+        return MetadataValue(static_cast<int64_t>(value));
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return MetadataValue(static_cast<double>(value));
+    } else if constexpr (std::is_same_v<T, Timestamp>) {
+        return MetadataValue(value);
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        return MetadataValue(std::string_view(value));
+    } else {
+        static_assert(kUnsupportedMetadataType<T>, "Metadata values are integers, doubles, strings or Timestamp");
+    }
+}
+
+// The type tag a value read as T must carry
+template <typename T>
+constexpr MetadataValue::Type metadataTypeOf() {
+    using Type = MetadataValue::Type;
+    if constexpr (std::is_integral_v<T>) return Type::Int;
+    else if constexpr (std::is_floating_point_v<T>) return Type::Double;
+    else if constexpr (std::is_same_v<T, Timestamp>) return Type::Timestamp;
+    else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) return Type::String;
+    else static_assert(kUnsupportedMetadataType<T>, "Metadata values are integers, doubles, strings or Timestamp");
+}
+
+template <typename T>
+bool holdsMetadataType(const MetadataValue& value) {
+    return value.getType() == metadataTypeOf<T>();
+}
+
+// Only valid when holdsMetadataType<T>(value)
+template <typename T>
+T fromMetadataValue(const MetadataValue& value) {
+    if constexpr (std::is_integral_v<T>) return static_cast<T>(value.asInt());
+    else if constexpr (std::is_floating_point_v<T>) return static_cast<T>(value.asDouble());
+    else if constexpr (std::is_same_v<T, Timestamp>) return value.asTimestamp();
+    else return T(value.asString());
+}
+
+// Flat key/value storage without per-key allocations: the first 7 entries live inside the object,
+// further ones spill into a vector. Lookups are a linear scan over the interned key ids.
+class CompactMetadata {
+private:
+    static constexpr size_t kInlineEntries = 7;  // Most tasks have fewer than 8 keys
+
+    uint8_t inlineCount = 0;
+    MetadataKey inlineKeys[kInlineEntries];
+    MetadataValue inlineValues[kInlineEntries];
+    std::vector<std::pair<MetadataKey, MetadataValue>> overflow;
+
+public:
+    // Replaces the value if the key is already present
+    void set(MetadataKey key, MetadataValue value) {
+        if (MetadataValue* existing = find(key)) {
+            *existing = std::move(value);
+        } else if (inlineCount < kInlineEntries) {
+            inlineKeys[inlineCount] = key;
+            inlineValues[inlineCount] = std::move(value);
+            ++inlineCount;
+        } else {
+            overflow.emplace_back(key, std::move(value));
+        }
+    }
+
+    const MetadataValue* find(MetadataKey key) const noexcept {
+        for (size_t i = 0; i < inlineCount; ++i) {
+            if (inlineKeys[i] == key) return &inlineValues[i];
+        }
+        for (const auto& [k, value] : overflow) {
+            if (k == key) return &value;
+        }
+        return nullptr;
+    }
+
+    MetadataValue* find(MetadataKey key) {
+        return const_cast<MetadataValue*>(static_cast<const CompactMetadata&>(*this).find(key));
+    }
+
+    size_t size() const {
+        return inlineCount + overflow.size();
+    }
+
+    // Calls fn(key, value) in insertion order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < inlineCount; ++i) fn(inlineKeys[i], inlineValues[i]);
+        for (const auto& [key, value] : overflow) fn(key, value);
+    }
+};
 
 // Task structure with metadata
 struct Task {
     std::string title;
-    std::unordered_map<std::string, std::any> metadata; // Flexible metadata storage
+    CompactMetadata metadata; // Flexible metadata storage
 
-    // Add metadata (can be any type)
+    // Add metadata (integers, floating point, strings or Timestamp)
     template <typename T>
     void addMetadata(const std::string& key, const T& value) {
-        metadata[key] = value;
+        metadata.set(MetadataKeyRegistry::global().intern(key), toMetadataValue(value));
+    }
+
+    // Fast-path lookups: never throw or log. nullopt when the key is missing or holds another type.
+    // T = std::string_view reads a string without copying it; T = std::string copies it.
+    template <typename T>
+    std::optional<T> tryGet(MetadataKey key) const noexcept(!std::is_same_v<T, std::string>) {
+        const MetadataValue* value = metadata.find(key);
+        if (!value || !holdsMetadataType<T>(*value)) return std::nullopt;
+        return fromMetadataValue<T>(*value);
+    }
+
+    // Same, by name: the name is looked up as a string_view, so nothing is allocated
+    template <typename T>
+    std::optional<T> tryGet(std::string_view key) const noexcept(!std::is_same_v<T, std::string>) {
+        std::optional<MetadataKey> id = MetadataKeyRegistry::global().find(key);
+        if (!id) return std::nullopt;
+        return tryGet<T>(*id);
     }
 
-    // Retrieve metadata safely
+    // The raw tagged value (nullptr if missing), for callers that dispatch on the type themselves
+    const MetadataValue* findMetadata(MetadataKey key) const noexcept {
+        return metadata.find(key);
+    }
+
+    // Retrieve metadata safely (throws and logs on a missing key or a type mismatch; see tryGet)
     template <typename T>
     T getMetadata(const std::string& key) const {
-        try {
-            return std::any_cast<T>(metadata.at(key));
-        } catch (const std::bad_any_cast& e) {
-            std::cerr << "Error: Type mismatch for metadata key '" << key << "'\n";
-            throw;
-        } catch (const std::out_of_range& e) {
+        std::optional<MetadataKey> id = MetadataKeyRegistry::global().find(key);
+        const MetadataValue* value = id ? metadata.find(*id) : nullptr;
+        if (!value) {
             std::cerr << "Error: Key '" << key << "' not found\n";
-            throw;
+            throw std::out_of_range("Metadata key not found: " + key);
+        }
+        if (!holdsMetadataType<T>(*value)) {
+            std::cerr << "Error: Type mismatch for metadata key '" << key << "'\n";
+            throw std::bad_any_cast();
         }
+        return fromMetadataValue<T>(*value);
     }
 };
 
 //Step 2: Function to Display Task Details
 //Code: Display Task Function
 
+void printTimestamp(std::ostream& out, Timestamp t) {
+    std::time_t seconds = static_cast<std::time_t>(t.secondsSinceEpoch);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S UTC", &utc);
+    out << buf;
+}
+
 void displayTask(const Task& task) {
     std::cout << "Task: " << task.title << "\n";
 
-    for (const auto& [key, value] : task.metadata) {
-        std::cout << "  " << key << ": ";
+    task.metadata.forEach([](MetadataKey key, const MetadataValue& value) {
+        std::cout << "  " << MetadataKeyRegistry::global().name(key) << ": ";
 
-        // Type-safe retrieval of metadata
-        if (value.type() == typeid(int)) {
-            std::cout << std::any_cast<int>(value);
-        } else if (value.type() == typeid(double)) {
-            std::cout << std::any_cast<double>(value);
-        } else if (value.type() == typeid(std::string)) {
-            std::cout << std::any_cast<std::string>(value);
-        } else {
-            std::cout << "[Unknown Type]";
+        // The value carries its type tag, so no RTTI is needed
+        switch (value.getType()) {
+            case MetadataValue::Type::Int:
+                std::cout << value.asInt();
+                break;
+            case MetadataValue::Type::Double:
+                std::cout << value.asDouble();
+                break;
+            case MetadataValue::Type::String:
+                std::cout << value.asString();
+                break;
+            case MetadataValue::Type::Timestamp:
+                printTimestamp(std::cout, value.asTimestamp());
+                break;
         }
         std::cout << "\n";
-    }
+    });
     std::cout << "----------------------\n";
 }
 
-//Step 3: Add Tasks with Metadata
+//Step 3: Metadata Columns for Queries Across Tasks
+// Per-task maps can answer "what is this task's Complexity" but not "which tasks have Complexity > 7".
+// MetadataColumnStore keeps one column per key: the column's type is inferred from the first value stored
+// under that key, values are kept row by row in a typed vector, and a null bitmap marks tasks without the key.
+// Scans and aggregations then run over plain int64/double arrays with no type checks in the loop.
+//Code: Metadata Columns
+
+// One bit per task row; bit i of words[i / 64] is row i
+class SelectionBitmap {
+public:
+    std::vector<uint64_t> words;
+    size_t rows = 0;
+
+    explicit SelectionBitmap(size_t n = 0) : words((n + 63) / 64, 0), rows(n) {}
+
+    void resize(size_t n) {
+        words.resize((n + 63) / 64, 0);
+        rows = n;
+    }
+
+    void set(size_t row) { words[row / 64] |= uint64_t(1) << (row % 64); }
+    bool test(size_t row) const { return (words[row / 64] >> (row % 64)) & 1; }
+
+    SelectionBitmap& operator&=(const SelectionBitmap& other) {
+        for (size_t i = 0; i < words.size(); ++i) words[i] &= i < other.words.size() ? other.words[i] : 0;
+        return *this;
+    }
+
+    size_t count() const {
+        size_t total = 0;
+        for (uint64_t word : words) total += __builtin_popcountll(word);
+        return total;
+    }
+
+    // Calls fn(row) for every selected row, in order
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t w = 0; w < words.size(); ++w) {
+            for (uint64_t word = words[w]; word != 0; word &= word - 1) fn(w * 64 + __builtin_ctzll(word));
+        }
+    }
+};
+
+template <typename T>
+struct ColumnStats {
+    size_t count = 0;  // Non-null values that matched
+    T min{};
+    T max{};
+    T sum{};
+};
+
+class MetadataColumnStore {
+public:
+    struct Column {
+        MetadataValue::Type type;
+        SelectionBitmap present;      // Null bitmap: bit set when the task has this key
+        std::vector<int64_t> ints;    // Int and Timestamp columns
+        std::vector<double> doubles;  // Double columns
+        std::vector<uint32_t> stringEnds;  // String columns: row i is chars[stringEnds[i-1] .. stringEnds[i])
+        std::string chars;
+    };
+
+    // Appends one row. Throws std::invalid_argument (and stores nothing) if a value's type differs
+    // from the type inferred for its key.
+    size_t append(const CompactMetadata& metadata) {
+        checkTypes(metadata);
+
+        size_t row = numRows++;
+        metadata.forEach([this, row](MetadataKey key, const MetadataValue& value) {
+            if (key >= columns.size()) columns.resize(key + 1);
+            if (!columns[key]) {
+                columns[key] = std::make_unique<Column>();
+                columns[key]->type = value.getType();
+            }
+            Column& column = *columns[key];
+            padTo(column, row);
+            column.present.set(row);
+            switch (column.type) {
+                case MetadataValue::Type::Int: column.ints.push_back(value.asInt()); break;
+                case MetadataValue::Type::Timestamp: column.ints.push_back(value.asTimestamp().secondsSinceEpoch); break;
+                case MetadataValue::Type::Double: column.doubles.push_back(value.asDouble()); break;
+                case MetadataValue::Type::String:
+                    column.chars.append(value.asString());
+                    column.stringEnds.push_back(static_cast<uint32_t>(column.chars.size()));
+                    break;
+            }
+        });
+        return row;
+    }
+
+    size_t size() const {
+        return numRows;
+    }
+
+    // Fixes the type of key without adding a row, e.g. from a snapshot's key table
+    void declare(MetadataKey key, MetadataValue::Type type) {
+        if (key >= columns.size()) columns.resize(key + 1);
+        if (!columns[key]) {
+            columns[key] = std::make_unique<Column>();
+            columns[key]->type = type;
+        } else if (columns[key]->type != type) {
+            throw std::invalid_argument("Metadata key '" + MetadataKeyRegistry::global().name(key) +
+                                        "' has a different type in an earlier task");
+        }
+    }
+
+    // Type checks like append and declares the metadata's new keys, but adds no row
+    void declare(const CompactMetadata& metadata) {
+        checkTypes(metadata);
+        metadata.forEach([this](MetadataKey key, const MetadataValue& value) { declare(key, value.getType()); });
+    }
+
+    // The inferred schema: nullptr for keys no task has
+    const Column* column(const std::string& key) const {
+        std::optional<MetadataKey> id = MetadataKeyRegistry::global().find(key);
+        return id && *id < columns.size() ? columns[*id].get() : nullptr;
+    }
+
+    // Tasks whose value for key lies in [lo, hi]. T is int64_t (Int and Timestamp columns) or double.
+    // A missing key or a column of another type selects nothing.
+    template <typename T>
+    SelectionBitmap whereBetween(const std::string& key, T lo, T hi) const {
+        SelectionBitmap selected(numRows);
+        const std::vector<T>* values = typedValues<T>(key);
+        if (!values) return selected;
+
+        // Rows past the column's end never had the key; their bits stay clear
+        size_t n = values->size();
+        for (size_t w = 0; w * 64 < n; ++w) {
+            uint64_t word = 0;
+            size_t end = std::min(n, w * 64 + 64);
+            for (size_t i = w * 64; i < end; ++i) {
+                T v = (*values)[i];
+                word |= static_cast<uint64_t>(v >= lo && v <= hi) << (i - w * 64);
+            }
+            selected.words[w] = word;
+        }
+        selected &= column(key)->present;  // Padding slots hold 0 and must not match
+        return selected;
+    }
+
+    // Count, min, max and sum over the non-null values of key, optionally only over selected rows
+    template <typename T>
+    ColumnStats<T> aggregate(const std::string& key, const SelectionBitmap* filter = nullptr) const {
+        ColumnStats<T> stats;
+        const std::vector<T>* values = typedValues<T>(key);
+        if (!values) return stats;
+
+        SelectionBitmap rows = column(key)->present;
+        if (filter) rows &= *filter;
+        rows.forEach([&](size_t row) {
+            T v = (*values)[row];
+            if (stats.count == 0) stats.min = stats.max = v;
+            stats.min = std::min(stats.min, v);
+            stats.max = std::max(stats.max, v);
+            stats.sum += v;
+            ++stats.count;
+        });
+        return stats;
+    }
+
+    // Value of a string column, or nullopt if the task has no such key
+    std::optional<std::string_view> stringAt(const std::string& key, size_t row) const {
+        const Column* c = column(key);
+        if (!c || c->type != MetadataValue::Type::String || row >= c->stringEnds.size() || !c->present.test(row)) {
+            return std::nullopt;
+        }
+        uint32_t begin = row == 0 ? 0 : c->stringEnds[row - 1];
+        return std::string_view(c->chars).substr(begin, c->stringEnds[row] - begin);
+    }
+
+private:
+    std::vector<std::unique_ptr<Column>> columns;  // Indexed by MetadataKey
+    size_t numRows = 0;
+
+    void checkTypes(const CompactMetadata& metadata) const {
+        metadata.forEach([this](MetadataKey key, const MetadataValue& value) {
+            const Column* column = key < columns.size() ? columns[key].get() : nullptr;
+            if (column && column->type != value.getType()) {
+                throw std::invalid_argument("Metadata key '" + MetadataKeyRegistry::global().name(key) +
+                                            "' has a different type in an earlier task");
+            }
+        });
+    }
+
+    // Fills rows that lacked the key with placeholder values so the column stays indexed by row
+    static void padTo(Column& column, size_t row) {
+        column.present.resize(row + 1);
+        switch (column.type) {
+            case MetadataValue::Type::Int:
+            case MetadataValue::Type::Timestamp: column.ints.resize(row, 0); break;
+            case MetadataValue::Type::Double: column.doubles.resize(row, 0.0); break;
+            case MetadataValue::Type::String: column.stringEnds.resize(row, static_cast<uint32_t>(column.chars.size())); break;
+        }
+    }
+
+    template <typename T>
+    const std::vector<T>* typedValues(const std::string& key) const {
+        const Column* c = column(key);
+        if (!c) return nullptr;
+        if constexpr (std::is_same_v<T, int64_t>) {
+            bool isInt = c->type == MetadataValue::Type::Int || c->type == MetadataValue::Type::Timestamp;
+            return isInt ? &c->ints : nullptr;
+        } else {
+            static_assert(std::is_same_v<T, double>, "Columns hold int64_t or double values");
+            return c->type == MetadataValue::Type::Double ? &c->doubles : nullptr;
+        }
+    }
+};
+
+//Step 4: Binary Snapshot and Append Log
+// Rebuilding every task from text on startup takes time proportional to the number of tasks. A snapshot
+// stores all tasks in one binary file that is mmap()ed and queried in place: records refer to each other
+// and to a string section by offset, so opening a snapshot only checks its header and key table.
+// Tasks added later go to an append-only log that is replayed on startup; checkpoint() folds them into
+// a new snapshot. Both store key names, not MetadataKey ids, since ids depend on interning order.
+// Logs are numbered (generations). A snapshot records the first generation it does not contain, so a log
+// left over from an interrupted checkpoint is recognized as already folded in and is not replayed twice.
+// Snapshot layout (native byte order, 8-byte aligned sections):
+//   SnapshotHeader | SnapshotKeyRecord[keyCount] | SnapshotTaskRecord[taskCount] |
+//   SnapshotEntryRecord[entryCount] | string bytes (key names, titles, string values)
+// The key table also holds each key's type, so the schema is known without reading the tasks.
+//Code: Snapshot and Log
+
+class MappedFile {
+    private:
+        const char* bytes = nullptr;
+        size_t length = 0;
+
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) throw std::runtime_error("Could not open " + path);
+
+            struct stat info{};
+            fstat(fd, &info);
+            length = static_cast<size_t>(info.st_size);
+            if (length > 0) {
+                void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED) {
+                    close(fd);
+                    throw std::runtime_error("Could not map " + path);
+                }
+                bytes = static_cast<const char*>(mapped);
+            }
+            close(fd); // The mapping stays valid without the descriptor
+        }
+
+        ~MappedFile() {
+            if (bytes) munmap(const_cast<char*>(bytes), length);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const char* data() const { return bytes; }
+        size_t size() const { return length; }
+    };
+
+// Makes temp the file at path. Its data is forced to disk before the rename and the directory entry
+// after it, so even after a power loss path holds either the old file or the complete new one.
+void renameDurably(const std::string& temp, const std::string& path) {
+    auto syncPath = [](const std::string& p) {
+        int fd = open(p.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open " + p);
+        int result = fsync(fd);
+        close(fd);
+        if (result != 0) throw std::runtime_error("Could not sync " + p);
+    };
+    syncPath(temp);
+    std::filesystem::rename(temp, path);
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    syncPath(dir.empty() ? "." : dir);
+}
+
+struct SnapshotHeader {
+    char magic[8];  // "FTMMSNAP"
+    uint32_t version;
+    uint32_t keyCount;
+    uint64_t taskCount;
+    uint64_t entryCount;
+    uint64_t keysOffset;
+    uint64_t tasksOffset;
+    uint64_t entriesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t logGeneration;  // Logs of this generation and later hold tasks the snapshot does not
+};
+
+struct SnapshotKeyRecord {
+    uint64_t nameOffset;  // Relative to the string section
+    uint32_t nameLength;
+    uint8_t type;         // MetadataValue::Type of every value stored under the key
+    uint8_t reserved[3];
+};
+
+struct SnapshotTaskRecord {
+    uint64_t titleOffset;
+    uint64_t firstEntry;  // The task's entries are entries[firstEntry .. firstEntry + entryCount)
+    uint32_t titleLength;
+    uint32_t entryCount;
+};
+
+struct SnapshotEntryRecord {
+    uint64_t value;         // Bits of the int64/double/timestamp, or a string's offset
+    uint32_t key;           // Index into the key records
+    uint32_t stringLength;
+    uint8_t type;           // MetadataValue::Type
+    uint8_t reserved[7];
+};
+
+static_assert(sizeof(SnapshotEntryRecord) == 24, "Snapshot records are written as raw bytes");
+
+const char kSnapshotMagic[8] = {'F', 'T', 'M', 'M', 'S', 'N', 'A', 'P'};
+const uint32_t kSnapshotVersion = 2;  // 2: log generation and key types
+
+struct LogHeader {
+    char magic[8];  // "FTMMLOG1"
+    uint64_t generation;
+};
+
+const char kLogMagic[8] = {'F', 'T', 'M', 'M', 'L', 'O', 'G', '1'};
+
+// Index of a key within one snapshot (see TaskSnapshot::findKey)
+using SnapshotKey = uint32_t;
+
+// Collects tasks and writes them as one snapshot file
+class SnapshotWriter {
+    private:
+        std::vector<SnapshotKeyRecord> keys;
+        std::unordered_map<MetadataKey, SnapshotKey> keyIndex;
+        std::vector<SnapshotTaskRecord> tasks;
+        std::vector<SnapshotEntryRecord> entries;
+        std::string strings;
+
+        uint64_t addString(std::string_view s) {
+            if (s.size() > UINT32_MAX) throw std::length_error("String too long for a snapshot");
+            uint64_t offset = strings.size();
+            strings.append(s);
+            return offset;
+        }
+
+        template <typename T>
+        static void writeSection(std::ofstream& out, const std::vector<T>& records) {
+            out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+        }
+
+    public:
+        void add(const Task& task) {
+            if (task.metadata.size() > UINT32_MAX) throw std::length_error("Too many metadata entries");
+            SnapshotTaskRecord record{};
+            record.titleOffset = addString(task.title);
+            record.titleLength = static_cast<uint32_t>(task.title.size());
+            record.firstEntry = entries.size();
+            record.entryCount = static_cast<uint32_t>(task.metadata.size());
+
+            task.metadata.forEach([this](MetadataKey key, const MetadataValue& value) {
+                auto [it, added] = keyIndex.emplace(key, static_cast<SnapshotKey>(keys.size()));
+                if (added) {
+                    const std::string& name = MetadataKeyRegistry::global().name(key);
+                    keys.push_back({addString(name), static_cast<uint32_t>(name.size()),
+                                    static_cast<uint8_t>(value.getType()), {}});
+                }
+
+                SnapshotEntryRecord entry{};
+                entry.key = it->second;
+                entry.type = static_cast<uint8_t>(value.getType());
+                switch (value.getType()) {
+                    case MetadataValue::Type::Int: entry.value = static_cast<uint64_t>(value.asInt()); break;
+                    case MetadataValue::Type::Double: {
+                        double v = value.asDouble();
+                        std::memcpy(&entry.value, &v, sizeof(v));
+                        break;
+                    }
+                    case MetadataValue::Type::Timestamp:
+                        entry.value = static_cast<uint64_t>(value.asTimestamp().secondsSinceEpoch);
+                        break;
+                    case MetadataValue::Type::String:
+                        entry.stringLength = static_cast<uint32_t>(value.asString().size());
+                        entry.value = addString(value.asString());
+                        break;
+                }
+                entries.push_back(entry);
+            });
+            tasks.push_back(record);
+        }
+
+        // Writes to a temporary file and renames it, so readers never see a half-written snapshot.
+        // logGeneration is the first log generation whose tasks are not in this snapshot.
+        void write(const std::string& path, uint64_t logGeneration) const {
+            SnapshotHeader header{};
+            std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+            header.version = kSnapshotVersion;
+            header.keyCount = static_cast<uint32_t>(keys.size());
+            header.taskCount = tasks.size();
+            header.entryCount = entries.size();
+            header.keysOffset = sizeof(SnapshotHeader);
+            header.tasksOffset = header.keysOffset + keys.size() * sizeof(SnapshotKeyRecord);
+            header.entriesOffset = header.tasksOffset + tasks.size() * sizeof(SnapshotTaskRecord);
+            header.stringsOffset = header.entriesOffset + entries.size() * sizeof(SnapshotEntryRecord);
+            header.stringsSize = strings.size();
+            header.logGeneration = logGeneration;
+
+            std::string temp = path + ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                writeSection(out, keys);
+                writeSection(out, tasks);
+                writeSection(out, entries);
+                out.write(strings.data(), strings.size());
+                if (!out.flush()) throw std::runtime_error("Could not write " + temp);
+            }
+            renameDurably(temp, path);
+        }
+    };
+
+// Read-only view of a snapshot file. Titles and values are read straight from the mapping;
+// string results are views into it and stay valid while the snapshot is open.
+class TaskSnapshot {
+    private:
+        MappedFile file;
+        const SnapshotHeader* header = nullptr;
+        const SnapshotTaskRecord* tasks = nullptr;
+        const SnapshotEntryRecord* entries = nullptr;
+        const char* strings = nullptr;
+        std::vector<std::string_view> keyNames;
+        std::vector<MetadataValue::Type> keyTypes;
+        std::unordered_map<std::string_view, SnapshotKey> keyIds;
+
+        std::string_view text(uint64_t offset, uint32_t length) const {
+            if (offset > header->stringsSize || length > header->stringsSize - offset) {
+                throw std::runtime_error("Corrupt snapshot record");
+            }
+            return std::string_view(strings + offset, length);
+        }
+
+        static bool sectionFits(uint64_t offset, uint64_t count, size_t recordSize, size_t fileSize) {
+            return offset <= fileSize && count <= (fileSize - offset) / recordSize;
+        }
+
+        // The task's entries, bounds-checked on access rather than at open
+        std::pair<const SnapshotEntryRecord*, const SnapshotEntryRecord*> entriesOf(size_t row) const {
+            const SnapshotTaskRecord& task = tasks[row];
+            if (task.firstEntry > header->entryCount || task.entryCount > header->entryCount - task.firstEntry) {
+                throw std::runtime_error("Corrupt snapshot record");
+            }
+            return {entries + task.firstEntry, entries + task.firstEntry + task.entryCount};
+        }
+
+    public:
+        // Checks the header, the section bounds and the key table: the cost does not depend on the task count
+        explicit TaskSnapshot(const std::string& path) : file(path) {
+            if (file.size() < sizeof(SnapshotHeader)) throw std::runtime_error(path + " is not a task snapshot");
+            header = reinterpret_cast<const SnapshotHeader*>(file.data());
+            if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+                header->version != kSnapshotVersion) {
+                throw std::runtime_error(path + " is not a task snapshot");
+            }
+            if (!sectionFits(header->keysOffset, header->keyCount, sizeof(SnapshotKeyRecord), file.size()) ||
+                !sectionFits(header->tasksOffset, header->taskCount, sizeof(SnapshotTaskRecord), file.size()) ||
+                !sectionFits(header->entriesOffset, header->entryCount, sizeof(SnapshotEntryRecord), file.size()) ||
+                !sectionFits(header->stringsOffset, header->stringsSize, 1, file.size()) ||
+                header->keysOffset % 8 != 0 || header->tasksOffset % 8 != 0 || header->entriesOffset % 8 != 0) {
+                throw std::runtime_error(path + " is truncated");
+            }
+            tasks = reinterpret_cast<const SnapshotTaskRecord*>(file.data() + header->tasksOffset);
+            entries = reinterpret_cast<const SnapshotEntryRecord*>(file.data() + header->entriesOffset);
+            strings = file.data() + header->stringsOffset;
+
+            const auto* keys = reinterpret_cast<const SnapshotKeyRecord*>(file.data() + header->keysOffset);
+            for (SnapshotKey key = 0; key < header->keyCount; ++key) {
+                if (keys[key].type > static_cast<uint8_t>(MetadataValue::Type::Timestamp)) {
+                    throw std::runtime_error("Corrupt snapshot record");
+                }
+                keyNames.push_back(text(keys[key].nameOffset, keys[key].nameLength));
+                keyTypes.push_back(static_cast<MetadataValue::Type>(keys[key].type));
+                keyIds.emplace(keyNames.back(), key);
+            }
+        }
+
+        size_t size() const {
+            return header->taskCount;
+        }
+
+        uint64_t logGeneration() const {
+            return header->logGeneration;
+        }
+
+        size_t keyCount() const {
+            return keyNames.size();
+        }
+
+        std::string_view keyName(SnapshotKey key) const {
+            return keyNames.at(key);
+        }
+
+        MetadataValue::Type keyType(SnapshotKey key) const {
+            return keyTypes.at(key);
+        }
+
+        std::string_view title(size_t row) const {
+            return text(tasks[row].titleOffset, tasks[row].titleLength);
+        }
+
+        std::optional<SnapshotKey> findKey(std::string_view name) const noexcept {
+            auto it = keyIds.find(name);
+            if (it == keyIds.end()) return std::nullopt;
+            return it->second;
+        }
+
+        // Like Task::tryGet: nullopt when the task lacks the key or it holds another type.
+        // T = std::string_view points into the mapping.
+        template <typename T>
+        std::optional<T> tryGet(size_t row, SnapshotKey key) const {
+            auto [entry, end] = entriesOf(row);
+            for (; entry != end; ++entry) {
+                if (entry->key != key) continue;
+                if (entry->type != static_cast<uint8_t>(metadataTypeOf<T>())) return std::nullopt;
+                if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+                    return T(text(entry->value, entry->stringLength));
+                } else if constexpr (std::is_floating_point_v<T>) {
+                    double v;
+                    std::memcpy(&v, &entry->value, sizeof(v));
+                    return static_cast<T>(v);
+                } else if constexpr (std::is_same_v<T, Timestamp>) {
+                    return Timestamp{static_cast<int64_t>(entry->value)};
+                } else {
+                    return static_cast<T>(static_cast<int64_t>(entry->value));
+                }
+            }
+            return std::nullopt;
+        }
+
+        template <typename T>
+        std::optional<T> tryGet(size_t row, std::string_view key) const {
+            std::optional<SnapshotKey> id = findKey(key);
+            if (!id) return std::nullopt;
+            return tryGet<T>(row, *id);
+        }
+
+        // Copies one task out of the snapshot
+        Task task(size_t row) const {
+            Task result{std::string(title(row)), {}};
+            auto [entry, end] = entriesOf(row);
+            for (; entry != end; ++entry) {
+                if (entry->key >= keyNames.size()) throw std::runtime_error("Corrupt snapshot record");
+                MetadataKey key = MetadataKeyRegistry::global().intern(keyNames[entry->key]);
+                switch (static_cast<MetadataValue::Type>(entry->type)) {
+                    case MetadataValue::Type::Int:
+                        result.metadata.set(key, MetadataValue(static_cast<int64_t>(entry->value)));
+                        break;
+                    case MetadataValue::Type::Double: {
+                        double v;
+                        std::memcpy(&v, &entry->value, sizeof(v));
+                        result.metadata.set(key, MetadataValue(v));
+                        break;
+                    }
+                    case MetadataValue::Type::Timestamp:
+                        result.metadata.set(key, MetadataValue(Timestamp{static_cast<int64_t>(entry->value)}));
+                        break;
+                    case MetadataValue::Type::String:
+                        result.metadata.set(key, MetadataValue(text(entry->value, entry->stringLength)));
+                        break;
+                    default:
+                        throw std::runtime_error("Corrupt snapshot record");
+                }
+            }
+            return result;
+        }
+    };
+
+// Append-only log of tasks added since the last snapshot: LogHeader, then records.
+// Record: payload length (4) | checksum (4) | title length (4) | title | entry count (4) | entries,
+// entry: name length (4) | name | type (1) | 8 value bytes, or for strings length (4) | bytes
+class TaskLog {
+    private:
+        int fd = -1;
+        std::string path;
+        uint64_t logGeneration;
+
+        static uint32_t checksum(const char* data, size_t size) {
+            uint32_t hash = 2166136261u; // FNV-1a
+            for (size_t i = 0; i < size; ++i) hash = (hash ^ static_cast<unsigned char>(data[i])) * 16777619u;
+            return hash;
+        }
+
+        template <typename T>
+        static void put(std::string& out, T value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static void putString(std::string& out, std::string_view s) {
+            put(out, static_cast<uint32_t>(s.size()));
+            out.append(s);
+        }
+
+        // Bounds-checked reads from one record; ok turns false instead of reading past the end
+        struct Reader {
+            const char* pos;
+            const char* end;
+            bool ok = true;
+
+            template <typename T>
+            T get() {
+                T value{};
+                if (static_cast<size_t>(end - pos) < sizeof(T)) {
+                    ok = false;
+                    return value;
+                }
+                std::memcpy(&value, pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
+
+            std::string_view getString() {
+                uint32_t length = get<uint32_t>();
+                if (!ok || static_cast<size_t>(end - pos) < length) {
+                    ok = false;
+                    return {};
+                }
+                std::string_view s(pos, length);
+                pos += length;
+                return s;
+            }
+        };
+
+        static bool decode(Reader& in, Task& task) {
+            task.title = std::string(in.getString());
+            uint32_t count = in.get<uint32_t>();
+            for (uint32_t i = 0; in.ok && i < count; ++i) {
+                MetadataKey key = MetadataKeyRegistry::global().intern(in.getString());
+                switch (static_cast<MetadataValue::Type>(in.get<uint8_t>())) {
+                    case MetadataValue::Type::Int: task.metadata.set(key, MetadataValue(in.get<int64_t>())); break;
+                    case MetadataValue::Type::Double: task.metadata.set(key, MetadataValue(in.get<double>())); break;
+                    case MetadataValue::Type::Timestamp:
+                        task.metadata.set(key, MetadataValue(Timestamp{in.get<int64_t>()}));
+                        break;
+                    case MetadataValue::Type::String: task.metadata.set(key, MetadataValue(in.getString())); break;
+                    default: return false;
+                }
+            }
+            return in.ok && in.pos == in.end;
+        }
+
+        // Replaces the file with an empty log of this generation. Written aside and renamed, so a crash
+        // leaves either the old log or the new one.
+        void startFile(uint64_t generation) {
+            LogHeader header{};
+            std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+            header.generation = generation;
+            std::string temp = path + ".tmp";
+            {
+                std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                if (!out.flush()) throw std::runtime_error("Could not write " + temp);
+            }
+            renameDurably(temp, path);
+
+            if (fd >= 0) close(fd);
+            fd = open(path.c_str(), O_WRONLY | O_APPEND);
+            if (fd < 0) throw std::runtime_error("Could not open log " + path);
+        }
+
+    public:
+        // Appends to the log at logPath if it has this generation; otherwise starts an empty one
+        TaskLog(std::string logPath, uint64_t generation) : path(std::move(logPath)), logGeneration(generation) {
+            if (generationOf(path) == generation) {
+                fd = open(path.c_str(), O_WRONLY | O_APPEND);
+                if (fd < 0) throw std::runtime_error("Could not open log " + path);
+            } else {
+                startFile(generation);
+            }
+        }
+
+        ~TaskLog() {
+            if (fd >= 0) close(fd);
+        }
+
+        TaskLog(const TaskLog&) = delete;
+        TaskLog& operator=(const TaskLog&) = delete;
+
+        // One write() per record; the record survives a crash of this process (call sync() for power loss)
+        void append(const Task& task) {
+            std::string record(8, '\0');
+            putString(record, task.title);
+            put(record, static_cast<uint32_t>(task.metadata.size()));
+            task.metadata.forEach([&record](MetadataKey key, const MetadataValue& value) {
+                putString(record, MetadataKeyRegistry::global().name(key));
+                put(record, static_cast<uint8_t>(value.getType()));
+                switch (value.getType()) {
+                    case MetadataValue::Type::Int: put(record, value.asInt()); break;
+                    case MetadataValue::Type::Double: put(record, value.asDouble()); break;
+                    case MetadataValue::Type::Timestamp: put(record, value.asTimestamp().secondsSinceEpoch); break;
+                    case MetadataValue::Type::String: putString(record, value.asString()); break;
+                }
+            });
+            uint32_t header[2] = {static_cast<uint32_t>(record.size() - 8), checksum(record.data() + 8, record.size() - 8)};
+            std::memcpy(&record[0], header, sizeof(header));
+
+            for (size_t written = 0; written < record.size();) {
+                ssize_t n = ::write(fd, record.data() + written, record.size() - written);
+                if (n < 0) throw std::runtime_error("Could not append to " + path);
+                written += static_cast<size_t>(n);
+            }
+        }
+
+        void sync() {
+            if (fdatasync(fd) != 0) throw std::runtime_error("Could not sync " + path);
+        }
+
+        uint64_t generation() const {
+            return logGeneration;
+        }
+
+        // Empties the log and moves it to the next generation (see TaskManager::checkpoint)
+        void restart(uint64_t generation) {
+            startFile(generation);
+            logGeneration = generation;
+        }
+
+        // The generation in the log's header; nullopt if there is no log or it has no valid header
+        static std::optional<uint64_t> generationOf(const std::string& path) {
+            LogHeader header{};
+            std::ifstream in(path, std::ios::binary);
+            if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0) {
+                return std::nullopt;
+            }
+            return header.generation;
+        }
+
+        // Calls onTask for every complete record. A torn or corrupt tail (from a crash mid-append) ends
+        // the replay and is cut off, so later appends are not hidden behind it.
+        template <typename Fn>
+        static void replay(const std::string& path, Fn onTask) {
+            if (!generationOf(path)) return;
+
+            MappedFile file(path);
+            const char* data = file.data();
+            size_t size = file.size(), pos = sizeof(LogHeader);
+            while (size - pos >= 8) {
+                uint32_t header[2];
+                std::memcpy(header, data + pos, sizeof(header));
+                if (header[0] > size - pos - 8 || checksum(data + pos + 8, header[0]) != header[1]) break;
+
+                Reader in{data + pos + 8, data + pos + 8 + header[0]};
+                Task task;
+                if (!decode(in, task)) break;
+                onTask(std::move(task));
+                pos += 8 + header[0];
+            }
+            if (pos < size) std::filesystem::resize_file(path, pos);
+        }
+    };
+
+//Step 5: Add Tasks with Metadata
 //Code: Task Manager
 
 class TaskManager {
     private:
+        // After openStorage, the tasks of the last snapshot stay in the mapping and tasks holds the ones
+        // added since. Rows (getTask, metadataColumns) count the snapshot's tasks first, then tasks.
         std::vector<Task> tasks;
+        std::unique_ptr<TaskSnapshot> snapshotFile;
+        std::unique_ptr<TaskLog> log;
+        std::string snapshotPath;
+        // Row i holds the metadata of getTask(i). Until the first query after opening a snapshot, it only
+        // holds the schema (see metadataColumns).
+        mutable MetadataColumnStore columns;
+        mutable bool columnsBuilt = true;
+
+        size_t snapshotSize() const {
+            return snapshotFile ? snapshotFile->size() : 0;
+        }
     
     public:
+        // Throws std::invalid_argument if a metadata value's type disagrees with earlier tasks
         void addTask(const Task& task) {
+            if (columnsBuilt) {
+                columns.append(task.metadata);
+            } else {
+                columns.declare(task.metadata);
+            }
             tasks.push_back(task);
+            if (log) log->append(task);
         }
     
         void showAllTasks() const {
+            if (snapshotFile) {
+                for (size_t row = 0; row < snapshotFile->size(); ++row) {
+                    displayTask(snapshotFile->task(row));
+                }
+            }
             for (const auto& task : tasks) {
                 displayTask(task);
             }
         }
+
+        // A copy for snapshot rows, which are not kept as Task objects
+        Task getTask(size_t row) const {
+            if (row < snapshotSize()) return snapshotFile->task(row);
+            return tasks.at(row - snapshotSize());
+        }
+
+        // Opening a snapshot does not read its tasks; the first query after it fills the columns from them
+        const MetadataColumnStore& metadataColumns() const {
+            if (!columnsBuilt) {
+                MetadataColumnStore built;
+                for (size_t row = 0; row < snapshotFile->size(); ++row) built.append(snapshotFile->task(row).metadata);
+                for (const auto& task : tasks) built.append(task.metadata);
+                columns = std::move(built);
+                columnsBuilt = true;
+            }
+            return columns;
+        }
+
+        // nullptr until openStorage finds a snapshot
+        const TaskSnapshot* snapshot() const {
+            return snapshotFile.get();
+        }
+
+        size_t size() const {
+            return snapshotSize() + tasks.size();
+        }
+
+        // Maps the snapshot (if there is one), replays the log and logs every later addTask
+        void openStorage(const std::string& snapshotFileName, const std::string& logFileName) {
+            snapshotPath = snapshotFileName;
+            log.reset();
+            snapshotFile.reset();
+            tasks.clear();
+            columns = MetadataColumnStore();
+            columnsBuilt = true;
+            if (std::filesystem::exists(snapshotPath)) {
+                snapshotFile = std::make_unique<TaskSnapshot>(snapshotPath);
+                for (SnapshotKey key = 0; key < snapshotFile->keyCount(); ++key) {
+                    columns.declare(MetadataKeyRegistry::global().intern(snapshotFile->keyName(key)),
+                                    snapshotFile->keyType(key));
+                }
+                columnsBuilt = snapshotFile->size() == 0;
+            }
+
+            // A log older than the snapshot is one a checkpoint already folded in before it was interrupted
+            uint64_t generation = snapshotFile ? snapshotFile->logGeneration() : 0;
+            std::optional<uint64_t> logGeneration = TaskLog::generationOf(logFileName);
+            if (logGeneration && *logGeneration >= generation) {
+                TaskLog::replay(logFileName, [this](Task task) { addTask(task); });
+                generation = *logGeneration;
+            }
+            log = std::make_unique<TaskLog>(logFileName, generation);
+        }
+
+        // Writes all tasks into a new snapshot and starts an empty log. The snapshot is renamed into place
+        // first, marked as holding this log's generation; a crash or power loss before the log restarts
+        // leaves a log openStorage skips. Rows keep their numbers, so the columns stay valid.
+        void checkpoint() {
+            if (!log) throw std::logic_error("checkpoint() needs openStorage()");
+            SnapshotWriter writer;
+            for (size_t row = 0; row < snapshotSize(); ++row) writer.add(snapshotFile->task(row));
+            for (const auto& task : tasks) writer.add(task);
+            uint64_t next = log->generation() + 1;
+            writer.write(snapshotPath, next);
+            snapshotFile = std::make_unique<TaskSnapshot>(snapshotPath);
+            tasks.clear();
+            log->restart(next);
+        }
+
+        // addTask survives a crash of this process; after sync() the tasks added so far also survive a power loss
+        void sync() {
+            if (!log) throw std::logic_error("sync() needs openStorage()");
+            log->sync();
+        }
     };
     
 
-//Step 4: Main Function to Test the Metadata System
+//Step 6: Benchmark: Memory per Task and Lookup Latency
+// Compares the compact representation with the previous one, std::unordered_map<std::string, std::any>,
+// on tasks with five metadata fields. Memory is the heap in use (glibc mallinfo2) divided by the task count.
+//Code: Benchmark
+
+struct MapTask {
+    std::string title;
+    std::unordered_map<std::string, std::any> metadata;
+};
+
+size_t heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;  // Large blocks (like the task vectors) are mmap()ed separately
+}
+
+void runMetadataBenchmark(size_t numTasks) {
+    const char* assignees[] = {"John Doe", "Jane Smith", "Alexandria Montgomery-Whitfield", "Li Wei"};
+    auto elapsedNs = [](std::chrono::steady_clock::time_point start, size_t ops) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+    };
+    std::cout << "Benchmark: " << numTasks << " tasks with 5 metadata fields\n";
+
+    const size_t numLookups = 10000000;
+    std::mt19937 rng(42);
+    std::vector<size_t> probes(numLookups);
+    for (auto& probe : probes) probe = rng() % numTasks;
+
+    int64_t checksum = 0;
+    {
+        size_t before = heapInUse();
+        std::vector<MapTask> tasks(numTasks);
+        for (size_t i = 0; i < numTasks; ++i) {
+            MapTask& task = tasks[i];
+            task.title = "Task " + std::to_string(i);
+            task.metadata["Priority"] = static_cast<int>(i % 10);
+            task.metadata["Deadline"] = std::string("2025-03-15");
+            task.metadata["Estimated Time"] = 12.5;
+            task.metadata["Assigned To"] = std::string(assignees[i % 4]);
+            task.metadata["Created"] = static_cast<int64_t>(1700000000 + i);
+        }
+        size_t bytes = heapInUse() - before;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t probe : probes) checksum += std::any_cast<int>(tasks[probe].metadata.at("Priority"));
+        std::cout << "unordered_map<string, any>: " << bytes / numTasks << " bytes/task, lookup "
+                  << elapsedNs(start, numLookups) << " ns\n";
+    }
+    {
+        size_t before = heapInUse();
+        std::vector<Task> tasks(numTasks);
+        for (size_t i = 0; i < numTasks; ++i) {
+            Task& task = tasks[i];
+            task.title = "Task " + std::to_string(i);
+            task.addMetadata("Priority", static_cast<int>(i % 10));
+            task.addMetadata("Deadline", std::string("2025-03-15"));
+            task.addMetadata("Estimated Time", 12.5);
+            task.addMetadata("Assigned To", std::string(assignees[i % 4]));
+            task.addMetadata("Created", Timestamp{static_cast<int64_t>(1700000000 + i)});
+        }
+        size_t bytes = heapInUse() - before;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t probe : probes) checksum += tasks[probe].getMetadata<int>("Priority");
+        double byName = elapsedNs(start, numLookups);
+
+        MetadataKey priority = MetadataKeyRegistry::global().intern("Priority");
+        start = std::chrono::steady_clock::now();
+        for (size_t probe : probes) checksum += tasks[probe].metadata.find(priority)->asInt();
+        std::cout << "CompactMetadata           : " << bytes / numTasks << " bytes/task, lookup " << byName
+                  << " ns by name, " << elapsedNs(start, numLookups) << " ns by interned key\n";
+    }
+    std::cout << "(checksum " << checksum << ")\n";
+}
+
+// "Complexity > 7": the per-task map with typeid checks vs. a column scan, plus an aggregation
+void runColumnBenchmark(size_t numTasks) {
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::mt19937 rng(7);
+    std::vector<MapTask> mapTasks(numTasks);
+    TaskManager manager;
+    for (size_t i = 0; i < numTasks; ++i) {
+        Task task{"Task " + std::to_string(i), {}};
+        int complexity = static_cast<int>(rng() % 10) + 1;
+        double hours = (rng() % 400) / 10.0;
+        if (i % 5 != 0) {  // Every fifth task has no complexity
+            task.addMetadata("Complexity", complexity);
+            mapTasks[i].metadata["Complexity"] = complexity;
+        }
+        task.addMetadata("Estimated Time", hours);
+        mapTasks[i].metadata["Estimated Time"] = hours;
+        manager.addTask(task);
+    }
+    std::cout << "\nColumn benchmark: " << numTasks << " tasks, Complexity > 7, total Estimated Time of those\n";
+
+    auto start = std::chrono::steady_clock::now();
+    size_t matches = 0;
+    double hours = 0;
+    for (const MapTask& task : mapTasks) {
+        auto complexity = task.metadata.find("Complexity");
+        if (complexity == task.metadata.end() || complexity->second.type() != typeid(int)) continue;
+        if (std::any_cast<int>(complexity->second) <= 7) continue;
+        ++matches;
+        auto time = task.metadata.find("Estimated Time");
+        if (time != task.metadata.end() && time->second.type() == typeid(double)) hours += std::any_cast<double>(time->second);
+    }
+    std::cout << "unordered_map<string, any>: " << elapsedMs(start) << " ms, " << matches << " tasks, " << hours << " h\n";
+
+    start = std::chrono::steady_clock::now();
+    const MetadataColumnStore& columns = manager.metadataColumns();
+    SelectionBitmap complex = columns.whereBetween<int64_t>("Complexity", 8, INT64_MAX);
+    ColumnStats<double> time = columns.aggregate<double>("Estimated Time", &complex);
+    std::cout << "MetadataColumnStore       : " << elapsedMs(start) << " ms, " << time.count << " tasks, " << time.sum
+              << " h\n";
+}
+
+
+// Hit and miss latency of getMetadata (throws and logs on a miss) against tryGet by name and by key id
+void runLookupBenchmark() {
+    // A small hot set, so the numbers show the lookup itself rather than cache misses
+    std::vector<Task> tasks(1024);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i].title = "Task " + std::to_string(i);
+        tasks[i].addMetadata("Priority", static_cast<int>(i % 10));
+        tasks[i].addMetadata("Deadline", std::string("2025-03-15"));
+        tasks[i].addMetadata("Estimated Time", 12.5);
+    }
+    MetadataKey priority = MetadataKeyRegistry::global().intern("Priority");
+    MetadataKey reviewer = MetadataKeyRegistry::global().intern("Reviewer");  // No task has it
+
+    // getMetadata's error messages go to a buffer that discards them (a real console would be slower still)
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return c; }
+    } nullBuffer;
+    std::streambuf* console = std::cerr.rdbuf(&nullBuffer);
+
+    int64_t checksum = 0;
+    auto time = [&tasks, &checksum](const char* label, size_t iterations, auto lookup) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) checksum += lookup(tasks[i % tasks.size()]);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+        std::cout << label << ns << " ns\n";
+    };
+
+    std::cout << "\nLookup benchmark (hit = Priority, miss = Reviewer)\n";
+    time("hit  getMetadata<int>(name)  : ", 10000000, [](const Task& t) { return t.getMetadata<int>("Priority"); });
+    time("hit  tryGet<int>(name)       : ", 10000000, [](const Task& t) { return t.tryGet<int>("Priority").value_or(0); });
+    time("hit  tryGet<int>(key id)     : ", 10000000, [priority](const Task& t) { return t.tryGet<int>(priority).value_or(0); });
+    time("miss getMetadata<int>(name)  : ", 100000, [](const Task& t) {
+        try {
+            return t.getMetadata<int>("Reviewer");
+        } catch (const std::out_of_range&) {
+            return -1;
+        }
+    });
+    time("miss tryGet<int>(name)       : ", 10000000, [](const Task& t) { return t.tryGet<int>("Reviewer").value_or(-1); });
+    time("miss tryGet<int>(key id)     : ", 10000000, [reviewer](const Task& t) { return t.tryGet<int>(reviewer).value_or(-1); });
+
+    std::cerr.rdbuf(console);
+    std::cout << "(checksum " << checksum << ")\n";
+}
+
+// Startup: rebuilding tasks with addTask (what a text import ends in) vs. opening a snapshot, plus the
+// cost of logging, replaying and checkpointing, and a query that reads the snapshot in place
+void runStorageBenchmark(size_t numTasks) {
+    auto elapsedMs = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / ("task-metadata-" + std::to_string(getpid()));
+    std::filesystem::create_directories(dir);
+    std::string snapshotPath = (dir / "tasks.snap").string();
+    std::string logPath = (dir / "tasks.log").string();
+
+    const char* assignees[] = {"John Doe", "Jane Smith", "Alexandria Montgomery-Whitfield", "Li Wei"};
+    auto addTasks = [&assignees, numTasks](TaskManager& manager) {
+        for (size_t i = 0; i < numTasks; ++i) {
+            Task task{"Task " + std::to_string(i), {}};
+            task.addMetadata("Priority", static_cast<int>(i % 10));
+            task.addMetadata("Deadline", std::string("2025-03-15"));
+            task.addMetadata("Estimated Time", 12.5);
+            task.addMetadata("Assigned To", std::string(assignees[i % 4]));
+            task.addMetadata("Created", Timestamp{static_cast<int64_t>(1700000000 + i)});
+            manager.addTask(task);
+        }
+    };
+    std::cout << "\nStorage benchmark: " << numTasks << " tasks with 5 metadata fields\n";
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        TaskManager rebuilt;
+        addTasks(rebuilt);
+        std::cout << "rebuild with addTask      : " << elapsedMs(start) << " ms\n";
+    }
+    {
+        TaskManager logged;
+        logged.openStorage(snapshotPath, logPath);
+        start = std::chrono::steady_clock::now();
+        addTasks(logged);
+        std::cout << "addTask with log          : " << elapsedMs(start) << " ms\n";
+        start = std::chrono::steady_clock::now();
+        logged.sync();
+        std::cout << "sync log                  : " << elapsedMs(start) << " ms\n";
+    }
+
+    start = std::chrono::steady_clock::now();
+    TaskManager replayed;
+    replayed.openStorage(snapshotPath, logPath);
+    std::cout << "open, replay log          : " << elapsedMs(start) << " ms (" << replayed.size() << " tasks)\n";
+
+    start = std::chrono::steady_clock::now();
+    replayed.checkpoint();
+    std::cout << "checkpoint                : " << elapsedMs(start) << " ms, snapshot "
+              << std::filesystem::file_size(snapshotPath) / 1024 << " KB\n";
+
+    start = std::chrono::steady_clock::now();
+    TaskManager opened;
+    opened.openStorage(snapshotPath, logPath);
+    std::cout << "open snapshot (mmap)      : " << elapsedMs(start) << " ms (" << opened.size() << " tasks)\n";
+
+    // First pass pages the snapshot in from the page cache
+    start = std::chrono::steady_clock::now();
+    const TaskSnapshot& snapshot = *opened.snapshot();
+    SnapshotKey priority = snapshot.findKey("Priority").value();
+    int64_t total = 0;
+    for (size_t row = 0; row < snapshot.size(); ++row) total += snapshot.tryGet<int>(row, priority).value_or(0);
+    std::cout << "sum Priority in place     : " << elapsedMs(start) << " ms (" << total << ")\n";
+
+    std::filesystem::remove_all(dir);
+}
+
+//Step 7: Main Function to Test the Metadata System
 //Code: Main Function
+// Run with --bench [numTasks] to compare memory and lookup latency with the old map-based storage
+// and startup from a snapshot with rebuilding the tasks.
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        size_t numTasks = argc > 2 ? std::stoul(argv[2]) : 1000000;
+        runMetadataBenchmark(numTasks);
+        runColumnBenchmark(numTasks);
+        runLookupBenchmark();
+        runStorageBenchmark(numTasks);
+        return 0;
+    }
 
-int main() {
     TaskManager manager;
 
     Task t1{"Complete AI Research Paper"};
@@ -91,6 +1475,7 @@ int main() {
     Task t2{"Bug Fix in Codebase"};
     t2.addMetadata("Assigned To", std::string("John Doe"));
     t2.addMetadata("Complexity", 8); // Integer complexity level
+    t2.addMetadata("Created", Timestamp{1740787200});
 
     manager.addTask(t1);
     manager.addTask(t2);
@@ -98,6 +1483,12 @@ int main() {
     // Display all tasks with metadata
     manager.showAllTasks();
 
+    // Query across tasks through the metadata columns
+    SelectionBitmap complex = manager.metadataColumns().whereBetween<int64_t>("Complexity", 8, INT64_MAX);
+    std::cout << "Tasks with Complexity > 7:";
+    complex.forEach([&manager](size_t row) { std::cout << " " << manager.getTask(row).title; });
+    std::cout << "\n";
+
     return 0;
 }
 
@@ -110,6 +1501,8 @@ int main() {
 // Task: Bug Fix in Codebase
 //   Assigned To: John Doe
 //   Complexity: 8
+//   Created: 2025-03-01 00:00:00 UTC
 // ----------------------
+// Tasks with Complexity > 7: Bug Fix in Codebase
 
 
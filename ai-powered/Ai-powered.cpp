@@ -2,53 +2,1079 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <array>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <cctype>
+#include <cstdint>
+#include <climits>
+#include <random>
+#include <cmath>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+// Build with -DSENTIMENT_NO_TFLITE on machines without TensorFlow Lite: only the n-gram fallback is available then
+#ifndef SENTIMENT_NO_TFLITE
 #include <tensorflow/lite/interpreter.h>
 #include <tensorflow/lite/model.h>
 #include <tensorflow/lite/kernels/register.h>
+#endif
 #include <wx/wx.h>
 
-// Function to load input text and convert to tensor
-std::vector<int> tokenizeText(const std::string& text) {
-    std::vector<int> tokens;
-    for (char c : text) {
-        tokens.push_back(static_cast<int>(c));  // Simple char-to-int conversion
+// Sentiment classes in the order of the model's output tensor
+const char* const kSentimentLabels[] = {"Negative", "Neutral", "Positive"};
+
+const char* sentimentLabel(int index) {
+    return kSentimentLabels[std::clamp(index, 0, 2)];
+}
+
+// WordPiece tokenizer over a vocabulary file (one token per line, ID = line number, "##" marks word continuations).
+// The vocabulary is a flat trie: a root for word-initial pieces and a root for "##" continuation pieces,
+// so the longest matching piece is found in one walk over the word's characters.
+class WordPieceTokenizer {
+public:
+    explicit WordPieceTokenizer(const std::string& vocabPath, bool lowercaseInput = true) : lowercase(lowercaseInput) {
+        std::ifstream file(vocabPath);
+        if (!file) throw std::runtime_error("Could not open vocabulary " + vocabPath);
+
+        // Build with std::map children first, then flatten into contiguous node/edge arrays
+        struct BuildNode {
+            std::map<unsigned char, uint32_t> children;
+            int32_t tokenId = -1;
+        };
+        std::vector<BuildNode> build(2);  // 0 = word root, 1 = "##" root
+
+        std::string piece;
+        int32_t id = 0;
+        while (std::getline(file, piece)) {
+            if (!piece.empty() && piece.back() == '\r') piece.pop_back();
+            uint32_t node = kWordRoot;
+            size_t start = 0;
+            if (piece.size() > 2 && piece.compare(0, 2, "##") == 0) {
+                node = kSuffixRoot;
+                start = 2;
+            }
+            for (size_t i = start; i < piece.size(); ++i) {
+                unsigned char c = static_cast<unsigned char>(piece[i]);
+                auto it = build[node].children.find(c);
+                if (it == build[node].children.end()) {
+                    build.emplace_back();
+                    it = build[node].children.emplace(c, static_cast<uint32_t>(build.size() - 1)).first;
+                }
+                node = it->second;
+            }
+            if (build[node].tokenId < 0) build[node].tokenId = id;
+            ++id;
+        }
+        vocabSize = static_cast<size_t>(id);
+
+        nodes.resize(build.size());
+        for (size_t i = 0; i < build.size(); ++i) {
+            nodes[i].firstEdge = static_cast<uint32_t>(edges.size());
+            nodes[i].edgeCount = static_cast<uint32_t>(build[i].children.size());
+            nodes[i].tokenId = build[i].tokenId;
+            for (const auto& [label, child] : build[i].children) edges.push_back(Edge{label, child});
+        }
+
+        unkId = idOf("[UNK]");
+        if (unkId < 0) throw std::runtime_error("Vocabulary has no [UNK] token");
+        padId = std::max(0, idOf("[PAD]"));
+        clsId = idOf("[CLS]");
+        sepId = idOf("[SEP]");
+    }
+
+    // Encodes "[CLS] pieces... [SEP]" into out[0..maxLen), truncating long texts and padding with [PAD].
+    // Returns the number of tokens before padding. Allocates nothing, so out can be an input tensor row.
+    template <typename T>
+    int encode(const std::string& text, T* out, int maxLen) const {
+        int len = 0;
+        if (clsId >= 0 && len < maxLen) out[len++] = static_cast<T>(clsId);
+        int limit = maxLen - (sepId >= 0 ? 1 : 0);  // Keep room for [SEP]
+
+        size_t i = 0;
+        while (i < text.size() && len < limit) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (isSpace(c)) {
+                ++i;
+                continue;
+            }
+            // Punctuation marks are words of their own
+            size_t wordEnd = i + 1;
+            if (!isPunct(c)) {
+                while (wordEnd < text.size()) {
+                    unsigned char w = static_cast<unsigned char>(text[wordEnd]);
+                    if (isSpace(w) || isPunct(w)) break;
+                    ++wordEnd;
+                }
+            }
+            encodeWord(text, i, wordEnd, out, len, limit);
+            i = wordEnd;
+        }
+
+        if (sepId >= 0 && len < maxLen) out[len++] = static_cast<T>(sepId);
+        int used = len;
+        std::fill(out + len, out + maxLen, static_cast<T>(padId));
+        return used;
+    }
+
+    size_t size() const { return vocabSize; }
+
+private:
+    static constexpr uint32_t kWordRoot = 0;
+    static constexpr uint32_t kSuffixRoot = 1;
+    static constexpr uint32_t kNoNode = UINT32_MAX;
+    static constexpr size_t kMaxWordChars = 100;  // Longer "words" become [UNK]
+
+    struct Node {
+        uint32_t firstEdge = 0;
+        uint32_t edgeCount = 0;
+        int32_t tokenId = -1;
+    };
+
+    struct Edge {
+        unsigned char label;
+        uint32_t child;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;  // Children of each node, sorted by label
+    size_t vocabSize = 0;
+    int32_t unkId = -1, padId = 0, clsId = -1, sepId = -1;
+    bool lowercase;
+
+    // ASCII-only checks: cheaper than the locale-aware <cctype> functions; UTF-8 bytes count as letters
+    static bool isSpace(unsigned char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+    static bool isPunct(unsigned char c) { return c < 128 && std::ispunct(c); }
+    static unsigned char toLower(unsigned char c) { return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
+
+    uint32_t child(uint32_t node, unsigned char label) const {
+        const Edge* first = edges.data() + nodes[node].firstEdge;
+        const Edge* last = first + nodes[node].edgeCount;
+        if (nodes[node].edgeCount > 8) {
+            first = std::lower_bound(first, last, label, [](const Edge& e, unsigned char l) { return e.label < l; });
+            return (first != last && first->label == label) ? first->child : kNoNode;
+        }
+        for (; first != last; ++first) {
+            if (first->label == label) return first->child;
+        }
+        return kNoNode;
+    }
+
+    int32_t idOf(const std::string& token) const {
+        uint32_t node = kWordRoot;
+        for (char c : token) {
+            node = child(node, static_cast<unsigned char>(c));
+            if (node == kNoNode) return -1;
+        }
+        return nodes[node].tokenId;
     }
-    return tokens;
+
+    // Greedy longest-match-first split of text[begin..end) into pieces; the whole word becomes [UNK] if any part has no piece
+    template <typename T>
+    void encodeWord(const std::string& text, size_t begin, size_t end, T* out, int& len, int limit) const {
+        int wordStart = len;
+        if (end - begin > kMaxWordChars) {
+            out[len++] = static_cast<T>(unkId);
+            return;
+        }
+
+        uint32_t root = kWordRoot;
+        for (size_t pos = begin; pos < end;) {
+            int32_t bestId = -1;
+            size_t bestEnd = pos;
+            uint32_t node = root;
+            for (size_t p = pos; p < end; ++p) {
+                unsigned char c = static_cast<unsigned char>(text[p]);
+                node = child(node, lowercase ? toLower(c) : c);
+                if (node == kNoNode) break;
+                if (nodes[node].tokenId >= 0) {
+                    bestId = nodes[node].tokenId;
+                    bestEnd = p + 1;
+                }
+            }
+
+            if (bestId < 0) {
+                len = wordStart;
+                out[len++] = static_cast<T>(unkId);
+                return;
+            }
+            if (len >= limit) return;  // Truncated in the middle of the word
+            out[len++] = static_cast<T>(bestId);
+            pos = bestEnd;
+            root = kSuffixRoot;
+        }
+    }
+};
+
+// Concurrent LRU cache from a normalized-text hash to the model's class probabilities, so repeated reviews
+// cost a hash lookup instead of an Invoke(). Split into shards, each with its own lock and LRU list,
+// so workers rarely contend. Keys are 64-bit hashes: a collision would return another text's
+// prediction, which is negligible at the cache sizes used here.
+class PredictionCache {
+public:
+    static constexpr size_t kNumClasses = 3;  // See kSentimentLabels
+    using Probabilities = std::array<float, kNumClasses>;
+
+    explicit PredictionCache(size_t maxBytes, size_t numShards = 16) : shards(std::max<size_t>(1, numShards)) {
+        size_t entries = maxBytes / kBytesPerEntry;
+        shardCapacity = std::max<size_t>(1, entries / shards.size());
+    }
+
+    // Hash of the text after lowercasing ASCII letters and collapsing/trimming whitespace,
+    // so "Great product!" and "  great   PRODUCT! " share an entry. Allocates nothing.
+    static uint64_t normalizedHash(const std::string& text) {
+        uint64_t hash = 14695981039346656037ull;  // FNV-1a
+        bool pendingSpace = false;
+        bool started = false;
+        for (char ch : text) {
+            unsigned char c = static_cast<unsigned char>(ch);
+            if (c == ' ' || (c >= '\t' && c <= '\r')) {
+                pendingSpace = started;
+                continue;
+            }
+            if (pendingSpace) {
+                hash = (hash ^ ' ') * 1099511628211ull;
+                pendingSpace = false;
+            }
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+            hash = (hash ^ c) * 1099511628211ull;
+            started = true;
+        }
+        return hash;
+    }
+
+    bool lookup(uint64_t key, Probabilities& out) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);  // Mark most recently used
+        out = it->second->probabilities;
+        hits.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void insert(uint64_t key, const Probabilities& probabilities) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            // Another worker classified the same text concurrently
+            it->second->probabilities = probabilities;
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return;
+        }
+        if (shard.index.size() >= shardCapacity) {
+            // Evict the least recently used entry and reuse its list node
+            shard.index.erase(shard.lru.back().key);
+            shard.lru.splice(shard.lru.begin(), shard.lru, std::prev(shard.lru.end()));
+            shard.lru.front() = Entry{key, probabilities};
+        } else {
+            shard.lru.push_front(Entry{key, probabilities});
+        }
+        shard.index.emplace(key, shard.lru.begin());
+    }
+
+    uint64_t hitCount() const { return hits.load(std::memory_order_relaxed); }
+    uint64_t missCount() const { return misses.load(std::memory_order_relaxed); }
+    size_t capacity() const { return shardCapacity * shards.size(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        Probabilities probabilities;
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        std::list<Entry> lru;  // Front = most recently used
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    };
+
+    // Entry plus list links, hash node and bucket pointer: an estimate of what one cached text costs
+    static constexpr size_t kBytesPerEntry = sizeof(Entry) + 2 * sizeof(void*) +
+                                             sizeof(std::pair<const uint64_t, std::list<Entry>::iterator>) +
+                                             3 * sizeof(void*);
+
+    std::vector<Shard> shards;
+    size_t shardCapacity;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+    Shard& shardFor(uint64_t key) {
+        // The low bits pick the hash map bucket, so use the high bits for the shard
+        return shards[(key >> 48) % shards.size()];
+    }
+};
+
+// Anything that classifies batches of texts. One instance per worker thread: implementations need not be thread-safe.
+class TextClassifier {
+public:
+    virtual ~TextClassifier() = default;
+
+    // Writes the predicted class of texts[0..count) into labels[0..count) (see sentimentLabel)
+    virtual void predict(const std::string* texts, size_t count, int* labels) = 0;
+};
+
+#ifndef SENTIMENT_NO_TFLITE
+// Write one text into a row of the input tensor (int32 token IDs, or floats for float-input models)
+void writeInputRow(const WordPieceTokenizer& tokenizer, const std::string& text, TfLiteTensor* input, int row, int seqLen) {
+    if (input->type == kTfLiteInt32) {
+        tokenizer.encode(text, input->data.i32 + static_cast<size_t>(row) * seqLen, seqLen);
+    } else if (input->type == kTfLiteFloat32) {
+        tokenizer.encode(text, input->data.f + static_cast<size_t>(row) * seqLen, seqLen);
+    } else {
+        throw std::runtime_error("Unsupported input tensor type");
+    }
+}
+
+// Load TensorFlow Lite model; every interpreter built from it keeps a reference, so it must outlive them
+std::shared_ptr<tflite::FlatBufferModel> loadModel(const std::string& modelPath) {
+    std::shared_ptr<tflite::FlatBufferModel> model = tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
+    if (!model) throw std::runtime_error("Could not load model " + modelPath);
+    return model;
 }
 
-// Load TensorFlow Lite model
-std::unique_ptr<tflite::Interpreter> loadModel(const std::string& modelPath) {
-    std::unique_ptr<tflite::FlatBufferModel> model = tflite::FlatBufferModel::BuildFromFile(modelPath.c_str());
+// Every TFLite call that can fail reports it through its status; carrying on would read or write tensors
+// that do not have the expected shape
+void checkStatus(TfLiteStatus status, const char* call) {
+    if (status != kTfLiteOk) throw std::runtime_error(std::string("TensorFlow Lite ") + call + " failed");
+}
+
+// Create an interpreter for the model (interpreters are not thread-safe: use one per thread)
+std::unique_ptr<tflite::Interpreter> createInterpreter(const tflite::FlatBufferModel& model) {
     tflite::ops::builtin::BuiltinOpResolver resolver;
     std::unique_ptr<tflite::Interpreter> interpreter;
 
-    tflite::InterpreterBuilder(*model, resolver)(&interpreter);
-    interpreter->AllocateTensors();
+    tflite::InterpreterBuilder(model, resolver)(&interpreter);
+    if (!interpreter) throw std::runtime_error("Could not create interpreter");
+    interpreter->SetNumThreads(1);  // Parallelism comes from running one interpreter per worker
+    checkStatus(interpreter->AllocateTensors(), "AllocateTensors");
     return interpreter;
 }
 
-// Run Sentiment Prediction
-std::string predictSentiment(tflite::Interpreter* interpreter, const std::string& text) {
-    auto tokens = tokenizeText(text);
-    
-    // Copy tokens to input tensor
-    float* inputTensor = interpreter->typed_input_tensor<float>(0);
-    for (size_t i = 0; i < tokens.size(); ++i) {
-        inputTensor[i] = tokens[i];
+// One interpreter that classifies a whole batch of texts per Invoke()
+class BatchPredictor : public TextClassifier {
+private:
+    std::shared_ptr<tflite::FlatBufferModel> model;  // Must outlive the interpreter
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    std::shared_ptr<const WordPieceTokenizer> tokenizer;
+    std::shared_ptr<PredictionCache> cache;
+    int inputIndex;
+    int seqLen;
+    int numClasses;
+    int allocatedBatch;  // Rows the input tensor has room for; grows, never shrinks
+    // Reused across calls when a cache is attached: texts that missed it and where their labels go
+    std::vector<const std::string*> missTexts;
+    std::vector<size_t> missSlots;
+    std::vector<uint64_t> missKeys;
+
+public:
+    // With a cache, texts it already knows skip the interpreter and new predictions are added to it
+    BatchPredictor(std::shared_ptr<tflite::FlatBufferModel> m, std::shared_ptr<const WordPieceTokenizer> t,
+                   std::shared_ptr<PredictionCache> c = nullptr)
+        : model(std::move(m)), interpreter(createInterpreter(*model)), tokenizer(std::move(t)), cache(std::move(c)) {
+        inputIndex = interpreter->inputs()[0];
+        TfLiteTensor* input = interpreter->input_tensor(0);
+        seqLen = input->dims->data[input->dims->size - 1];
+        allocatedBatch = input->dims->size > 1 ? input->dims->data[0] : 1;
+        TfLiteTensor* output = interpreter->output_tensor(0);
+        numClasses = output->dims->data[output->dims->size - 1];
+        if (cache && numClasses != static_cast<int>(PredictionCache::kNumClasses)) {
+            throw std::runtime_error("Model output does not match the prediction cache");
+        }
+    }
+
+    void predict(const std::string* texts, size_t count, int* labels) override {
+        if (!cache) {
+            run(texts, count, labels);
+            return;
+        }
+
+        missTexts.clear();
+        missSlots.clear();
+        missKeys.clear();
+        PredictionCache::Probabilities probabilities;
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t key = PredictionCache::normalizedHash(texts[i]);
+            if (cache->lookup(key, probabilities)) {
+                labels[i] = argmax(probabilities.data());
+            } else {
+                missTexts.push_back(&texts[i]);
+                missSlots.push_back(i);
+                missKeys.push_back(key);
+            }
+        }
+        if (missTexts.empty()) return;
+
+        const float* output = invoke(missTexts.size(), [&](size_t i) -> const std::string& { return *missTexts[i]; });
+        for (size_t i = 0; i < missTexts.size(); ++i) {
+            const float* row = output + i * numClasses;
+            std::copy(row, row + numClasses, probabilities.begin());
+            cache->insert(missKeys[i], probabilities);
+            labels[missSlots[i]] = argmax(row);
+        }
+    }
+
+private:
+    int argmax(const float* row) const {
+        return static_cast<int>(std::max_element(row, row + numClasses) - row);
+    }
+
+    void run(const std::string* texts, size_t count, int* labels) {
+        const float* output = invoke(count, [&](size_t i) -> const std::string& { return texts[i]; });
+        for (size_t i = 0; i < count; ++i) labels[i] = argmax(output + i * numClasses);
+    }
+
+    // Runs one Invoke() over textAt(0..count) and returns the output; its first count rows are the results.
+    // A smaller batch reuses the allocated tensors (the extra rows are classified too, and ignored)
+    // rather than reallocating for every short final chunk.
+    template <typename TextAt>
+    const float* invoke(size_t count, TextAt textAt) {
+        int batch = static_cast<int>(count);
+        if (batch > allocatedBatch) {
+            // Reshape the input to [batch, seqLen]. Fails on models with a fixed batch size.
+            checkStatus(interpreter->ResizeInputTensor(inputIndex, {batch, seqLen}), "ResizeInputTensor");
+            checkStatus(interpreter->AllocateTensors(), "AllocateTensors");
+            allocatedBatch = batch;
+        }
+
+        TfLiteTensor* input = interpreter->input_tensor(0);
+        if (input->dims->size < 2 || input->dims->data[0] < batch || input->dims->data[input->dims->size - 1] != seqLen) {
+            throw std::runtime_error("Model input has no room for a batch of " + std::to_string(batch));
+        }
+        for (int i = 0; i < batch; ++i) {
+            writeInputRow(*tokenizer, textAt(i), input, i, seqLen);
+        }
+
+        checkStatus(interpreter->Invoke(), "Invoke");
+        return interpreter->typed_output_tensor<float>(0);
+    }
+};
+
+// Pool of interpreters (one per worker thread) sharing a single FlatBufferModel, tokenizer and optional cache
+class SentimentEngine {
+private:
+    std::vector<std::unique_ptr<BatchPredictor>> predictors;
+    size_t maxBatch;
+
+public:
+    SentimentEngine(std::shared_ptr<tflite::FlatBufferModel> m, std::shared_ptr<const WordPieceTokenizer> t,
+                    size_t numThreads, size_t batchSize, std::shared_ptr<PredictionCache> c = nullptr)
+        : maxBatch(std::max<size_t>(1, batchSize)) {
+        for (size_t i = 0; i < std::max<size_t>(1, numThreads); ++i) {
+            predictors.push_back(std::make_unique<BatchPredictor>(m, t, c));
+        }
+    }
+
+    // Classify all texts; returns one class index per text (see sentimentLabel)
+    std::vector<int> predictBatch(const std::vector<std::string>& texts) {
+        std::vector<int> labels(texts.size());
+        size_t numChunks = (texts.size() + maxBatch - 1) / maxBatch;
+        std::atomic<size_t> nextChunk{0};
+
+        // Each worker owns one interpreter and pulls chunks of up to maxBatch texts.
+        // After a failure the others stop taking chunks, and the error reaches the caller through its future.
+        auto work = [&](BatchPredictor& predictor) {
+            try {
+                for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++) {
+                    size_t begin = chunk * maxBatch;
+                    size_t count = std::min(maxBatch, texts.size() - begin);
+                    predictor.predict(&texts[begin], count, &labels[begin]);
+                }
+            } catch (...) {
+                nextChunk = numChunks;
+                throw;
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        for (size_t i = 1; i < std::min(predictors.size(), numChunks); ++i) {
+            workers.push_back(std::async(std::launch::async, work, std::ref(*predictors[i])));
+        }
+        std::exception_ptr error;
+        try {
+            work(*predictors[0]);  // The calling thread is worker 0
+        } catch (...) {
+            error = std::current_exception();
+        }
+        for (auto& worker : workers) {
+            try {
+                worker.get();
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+
+        return labels;
+    }
+};
+#endif  // SENTIMENT_NO_TFLITE
+
+// Dependency-free fallback classifier (fastText-style): every word and word bigram is hashed into a bucket,
+// the buckets' embeddings are summed into a hidden vector, and a linear layer scores the classes.
+// Classifying a text is one pass over its bytes plus a few dozen vector adds, so it takes microseconds.
+// Trained offline from "label<TAB>text" lines and saved as a small binary file (see --train-fallback).
+class NGramClassifier {
+public:
+    static constexpr size_t kDim = 16;  // Two AVX2 registers per embedding row
+    static constexpr size_t kNumClasses = 3;
+
+    struct Example {
+        int label;
+        std::string text;
+    };
+
+    explicit NGramClassifier(size_t buckets = size_t(1) << 18)
+        : numBuckets(buckets), embeddings(buckets * kDim, 0.0f), output(kNumClasses * kDim, 0.0f) {}
+
+    // Reads "label<TAB>text" lines; the label is Negative, Neutral or Positive (any case) or 0..2
+    static std::vector<Example> readLabeled(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) throw std::runtime_error("Could not open " + path);
+
+        std::vector<Example> examples;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) continue;
+            int label = parseLabel(line.substr(0, tab));
+            if (label < 0) throw std::runtime_error("Unknown label in " + path + ": " + line.substr(0, tab));
+            examples.push_back(Example{label, line.substr(tab + 1)});
+        }
+        return examples;
+    }
+
+    // Softmax regression with SGD and a linearly decaying learning rate, as fastText's supervised mode
+    void train(const std::vector<Example>& examples, int epochs, float learningRate) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> init(-1.0f / kDim, 1.0f / kDim);
+        for (float& w : embeddings) w = init(rng);
+        std::fill(output.begin(), output.end(), 0.0f);
+
+        std::vector<size_t> order(examples.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::vector<uint32_t> features;
+        size_t totalSteps = std::max<size_t>(1, examples.size() * epochs);
+        size_t step = 0;
+
+        for (int epoch = 0; epoch < epochs; ++epoch) {
+            std::shuffle(order.begin(), order.end(), rng);
+            for (size_t index : order) {
+                const Example& example = examples[index];
+                float lr = learningRate * (1.0f - static_cast<float>(step++) / totalSteps);
+
+                features.clear();
+                forEachFeature(example.text, [&](uint32_t bucket) { features.push_back(bucket); });
+                if (features.empty()) continue;
+
+                float hidden[kDim] = {};
+                for (uint32_t bucket : features) addRow(hidden, &embeddings[bucket * kDim], 1.0f);
+                for (float& h : hidden) h /= features.size();
+
+                float scores[kNumClasses];
+                softmax(hidden, scores);
+
+                // Gradient of the log-loss: the output layer first, then back into the hidden vector
+                float gradHidden[kDim] = {};
+                for (size_t c = 0; c < kNumClasses; ++c) {
+                    float g = lr * ((static_cast<int>(c) == example.label ? 1.0f : 0.0f) - scores[c]);
+                    addRow(gradHidden, &output[c * kDim], g);
+                    addRow(&output[c * kDim], hidden, g);
+                }
+                for (uint32_t bucket : features) addRow(&embeddings[bucket * kDim], gradHidden, 1.0f / features.size());
+            }
+        }
+    }
+
+    // Thread-safe and allocation-free
+    int predict(const std::string& text) const {
+#ifdef __AVX2__
+        __m256 lo = _mm256_setzero_ps();
+        __m256 hi = _mm256_setzero_ps();
+        forEachFeature(text, [&](uint32_t bucket) {
+            const float* row = &embeddings[bucket * kDim];
+            lo = _mm256_add_ps(lo, _mm256_loadu_ps(row));
+            hi = _mm256_add_ps(hi, _mm256_loadu_ps(row + 8));
+        });
+        // The mean only rescales every score by the same factor, so the argmax needs just the sum
+        int best = 0;
+        float bestScore = 0.0f;
+        for (size_t c = 0; c < kNumClasses; ++c) {
+            const float* w = &output[c * kDim];
+            __m256 prod = _mm256_add_ps(_mm256_mul_ps(lo, _mm256_loadu_ps(w)), _mm256_mul_ps(hi, _mm256_loadu_ps(w + 8)));
+            __m128 sum = _mm_add_ps(_mm256_castps256_ps128(prod), _mm256_extractf128_ps(prod, 1));
+            sum = _mm_hadd_ps(sum, sum);
+            sum = _mm_hadd_ps(sum, sum);
+            float score = _mm_cvtss_f32(sum);
+            if (c == 0 || score > bestScore) {
+                best = static_cast<int>(c);
+                bestScore = score;
+            }
+        }
+        return best;
+#else
+        float hidden[kDim] = {};
+        forEachFeature(text, [&](uint32_t bucket) { addRow(hidden, &embeddings[bucket * kDim], 1.0f); });
+        int best = 0;
+        float bestScore = 0.0f;
+        for (size_t c = 0; c < kNumClasses; ++c) {
+            float score = 0.0f;
+            for (size_t i = 0; i < kDim; ++i) score += hidden[i] * output[c * kDim + i];
+            if (c == 0 || score > bestScore) {
+                best = static_cast<int>(c);
+                bestScore = score;
+            }
+        }
+        return best;
+#endif
+    }
+
+    void save(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Could not write " + path);
+        uint32_t header[] = {kMagic, static_cast<uint32_t>(numBuckets), kDim, kNumClasses};
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(embeddings.data()), embeddings.size() * sizeof(float));
+        file.write(reinterpret_cast<const char*>(output.data()), output.size() * sizeof(float));
+        if (!file) throw std::runtime_error("Could not write " + path);
+    }
+
+    static NGramClassifier load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) throw std::runtime_error("Could not open model " + path);
+        uint32_t header[4];
+        if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != kMagic ||
+            header[2] != kDim || header[3] != kNumClasses || header[1] == 0) {
+            throw std::runtime_error(path + " is not an n-gram sentiment model");
+        }
+
+        NGramClassifier model(header[1]);
+        file.read(reinterpret_cast<char*>(model.embeddings.data()), model.embeddings.size() * sizeof(float));
+        file.read(reinterpret_cast<char*>(model.output.data()), model.output.size() * sizeof(float));
+        if (!file) throw std::runtime_error(path + " is truncated");
+        return model;
+    }
+
+private:
+    static constexpr uint32_t kMagic = 0x4D52474E;  // "NGRM"
+
+    size_t numBuckets;
+    std::vector<float> embeddings;  // [numBuckets][kDim]
+    std::vector<float> output;      // [kNumClasses][kDim]
+
+    static int parseLabel(std::string label) {
+        for (char& c : label) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        for (int i = 0; i < static_cast<int>(kNumClasses); ++i) {
+            std::string name = kSentimentLabels[i];
+            name[0] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[0])));
+            if (label == name || label == std::to_string(i)) return i;
+        }
+        return -1;
+    }
+
+    // Calls f(bucket) for every lowercased word and word bigram; words split like the WordPiece tokenizer
+    template <typename F>
+    void forEachFeature(const std::string& text, F f) const {
+        uint64_t previous = 0;
+        bool hasPrevious = false;
+        size_t i = 0;
+        while (i < text.size()) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c == ' ' || (c >= '\t' && c <= '\r')) {
+                ++i;
+                continue;
+            }
+            uint64_t hash = 14695981039346656037ull;  // FNV-1a
+            bool punct = c < 128 && std::ispunct(c);
+            do {
+                unsigned char w = static_cast<unsigned char>(text[i]);
+                if (w >= 'A' && w <= 'Z') w += 'a' - 'A';
+                hash = (hash ^ w) * 1099511628211ull;
+                ++i;
+            } while (!punct && i < text.size() && !isBoundary(static_cast<unsigned char>(text[i])));
+
+            f(static_cast<uint32_t>(hash % numBuckets));
+            if (hasPrevious) f(static_cast<uint32_t>((previous * 116049371ull + hash) % numBuckets));
+            previous = hash;
+            hasPrevious = true;
+        }
+    }
+
+    static bool isBoundary(unsigned char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r') || (c < 128 && std::ispunct(c));
+    }
+
+    static void addRow(float* dst, const float* src, float scale) {
+        for (size_t i = 0; i < kDim; ++i) dst[i] += scale * src[i];
+    }
+
+    void softmax(const float* hidden, float* scores) const {
+        float maxScore = -1e30f;
+        for (size_t c = 0; c < kNumClasses; ++c) {
+            scores[c] = 0.0f;
+            for (size_t i = 0; i < kDim; ++i) scores[c] += hidden[i] * output[c * kDim + i];
+            maxScore = std::max(maxScore, scores[c]);
+        }
+        float sum = 0.0f;
+        for (size_t c = 0; c < kNumClasses; ++c) {
+            scores[c] = std::exp(scores[c] - maxScore);
+            sum += scores[c];
+        }
+        for (size_t c = 0; c < kNumClasses; ++c) scores[c] /= sum;
+    }
+};
+
+// Worker-side adapter: the n-gram model is read-only, so all workers share one instance
+class NGramPredictor : public TextClassifier {
+private:
+    std::shared_ptr<const NGramClassifier> model;
+
+public:
+    explicit NGramPredictor(std::shared_ptr<const NGramClassifier> m) : model(std::move(m)) {}
+
+    void predict(const std::string* texts, size_t count, int* labels) override {
+        for (size_t i = 0; i < count; ++i) labels[i] = model->predict(texts[i]);
+    }
+};
+
+#ifndef SENTIMENT_NO_TFLITE
+const char* const kDefaultModelPath = "text_classification.tflite";
+#else
+const char* const kDefaultModelPath = "sentiment.ngram";
+#endif
+
+// One classifier per worker: the TFLite model for .tflite files, otherwise a model written by --train-fallback.
+// The cache only fronts TFLite; the n-gram model is cheaper than a cache lookup.
+std::vector<std::unique_ptr<TextClassifier>> createClassifiers(const std::string& modelPath, const std::string& vocabPath,
+                                                               size_t count, std::shared_ptr<PredictionCache> cache) {
+    std::vector<std::unique_ptr<TextClassifier>> classifiers;
+    bool isTFLite = modelPath.size() >= 7 && modelPath.compare(modelPath.size() - 7, 7, ".tflite") == 0;
+    if (isTFLite) {
+#ifndef SENTIMENT_NO_TFLITE
+        auto model = loadModel(modelPath);
+        auto tokenizer = std::make_shared<const WordPieceTokenizer>(vocabPath);
+        for (size_t i = 0; i < std::max<size_t>(1, count); ++i) {
+            classifiers.push_back(std::make_unique<BatchPredictor>(model, tokenizer, cache));
+        }
+        return classifiers;
+#else
+        (void)vocabPath;
+        (void)cache;
+        throw std::runtime_error("Built without TensorFlow Lite: train a fallback model with --train-fallback");
+#endif
+    }
+
+    auto model = std::make_shared<const NGramClassifier>(NGramClassifier::load(modelPath));
+    for (size_t i = 0; i < std::max<size_t>(1, count); ++i) {
+        classifiers.push_back(std::make_unique<NGramPredictor>(model));
+    }
+    return classifiers;
+}
+
+// Fixed-capacity queue between threads: push() blocks while full, so a fast producer can't run away with memory
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    bool closed = false;
+
+public:
+    explicit BoundedQueue(size_t cap) : capacity(std::max<size_t>(1, cap)) {}
+
+    // Returns false if the queue was closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mtx);
+        notFull.wait(lock, [this] { return items.size() < capacity || closed; });
+        if (closed) return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Waits for at least one item, then takes up to maxItems; returns false once closed and drained
+    bool popBatch(std::vector<T>& out, size_t maxItems) {
+        out.clear();
+        std::unique_lock<std::mutex> lock(mtx);
+        notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        while (!items.empty() && out.size() < maxItems) {
+            out.push_back(std::move(items.front()));
+            items.pop_front();
+        }
+        notFull.notify_all();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
     }
+};
+
+// Asynchronous inference: texts go into a bounded queue, worker threads (one classifier each)
+// classify whatever is queued as one batch and report each result through its callback.
+// Used by the headless CLI and by the GUI, so neither blocks on inference.
+class SentimentService {
+public:
+    // Receives a ready future: get() returns the label, or rethrows what the classifier threw
+    using Callback = std::function<void(std::future<int> result)>;
 
-    // Run inference
-    interpreter->Invoke();
+    // Starts one worker per classifier (see createClassifiers)
+    SentimentService(std::vector<std::unique_ptr<TextClassifier>> classifiers, size_t batchSize, size_t queueCapacity)
+        : predictors(std::move(classifiers)), maxBatch(std::max<size_t>(1, batchSize)), jobs(queueCapacity) {
+        if (predictors.empty()) throw std::runtime_error("SentimentService needs at least one classifier");
+        for (auto& predictor : predictors) {
+            workers.emplace_back(&SentimentService::workerLoop, this, std::ref(*predictor));
+        }
+    }
+
+    // Finishes every queued text before returning
+    ~SentimentService() {
+        jobs.close();
+        for (auto& t : workers) t.join();
+    }
 
-    // Get output tensor (probability of sentiment classes)
-    float* outputTensor = interpreter->typed_output_tensor<float>(0);
-    
-    // Determine sentiment class
-    int sentimentIndex = std::distance(outputTensor, std::max_element(outputTensor, outputTensor + 3));
-    
-    if (sentimentIndex == 0) return "Negative";
-    else if (sentimentIndex == 1) return "Neutral";
-    else return "Positive";
+    SentimentService(const SentimentService&) = delete;
+    SentimentService& operator=(const SentimentService&) = delete;
+
+    // Queues a text; blocks while the queue is full. done runs on a worker thread.
+    void submit(std::string text, Callback done) {
+        jobs.push(Job{std::move(text), {}, std::move(done)});
+    }
+
+private:
+    struct Job {
+        std::string text;
+        std::promise<int> result;
+        Callback done;
+    };
+
+    std::vector<std::unique_ptr<TextClassifier>> predictors;
+    size_t maxBatch;
+    BoundedQueue<Job> jobs;
+    std::vector<std::thread> workers;
+
+    void workerLoop(TextClassifier& predictor) {
+        std::vector<Job> batch;
+        std::vector<std::string> texts;
+        std::vector<int> labels;
+        while (jobs.popBatch(batch, maxBatch)) {
+            texts.clear();
+            for (auto& job : batch) texts.push_back(std::move(job.text));
+            labels.resize(batch.size());
+
+            // A failed batch fails each of its jobs; the worker keeps serving the next ones
+            try {
+                predictor.predict(texts.data(), texts.size(), labels.data());
+                for (size_t i = 0; i < batch.size(); ++i) batch[i].result.set_value(labels[i]);
+            } catch (...) {
+                for (auto& job : batch) job.result.set_exception(std::current_exception());
+            }
+            for (auto& job : batch) job.done(job.result.get_future());
+        }
+    }
+};
+
+// Headless mode: reads one text per line from a file (or stdin for "-") and writes one label per line,
+// in input order, to stdout. Needs no display, so it can run inside production pipelines.
+// A text that could not be classified gets an "Error" line (the reason goes to stderr) and the exit status is 1.
+int runHeadless(const std::string& inputPath, const std::string& modelPath, const std::string& vocabPath) {
+    std::ifstream file;
+    if (inputPath != "-") {
+        file.open(inputPath);
+        if (!file) {
+            std::cerr << "Error: Could not open " << inputPath << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = inputPath == "-" ? std::cin : file;
+
+    // Workers finish out of order; results wait here until every earlier line has been written
+    std::mutex outMtx;
+    std::map<uint64_t, const char*> pending;
+    uint64_t nextToWrite = 0;
+    bool failed = false;
+    auto writeInOrder = [&](uint64_t seq, std::future<int> result) {
+        const char* label = "Error";
+        try {
+            label = sentimentLabel(result.get());
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(outMtx);
+            std::cerr << "Error: line " << seq + 1 << ": " << e.what() << "\n";
+            failed = true;
+        }
+        std::lock_guard<std::mutex> lock(outMtx);
+        pending.emplace(seq, label);
+        for (auto it = pending.begin(); it != pending.end() && it->first == nextToWrite; it = pending.erase(it)) {
+            std::cout << it->second << "\n";
+            ++nextToWrite;
+        }
+        if (pending.empty()) std::cout.flush();  // Caught up: let downstream readers see the results
+    };
+
+    // Review streams repeat themselves a lot; 64 MB holds about a million predictions
+    auto cache = std::make_shared<PredictionCache>(64u << 20);
+    {
+        size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        SentimentService service(createClassifiers(modelPath, vocabPath, threads, cache), 32, 1024);
+        std::string line;
+        for (uint64_t seq = 0; std::getline(in, line); ++seq) {
+            service.submit(std::move(line), [&writeInOrder, seq](std::future<int> result) {
+                writeInOrder(seq, std::move(result));
+            });
+        }
+    }  // Service destructor drains the queue
+
+    std::cout.flush();
+    if (cache->hitCount() + cache->missCount() > 0) {
+        std::cerr << "cache: " << cache->hitCount() << " hits, " << cache->missCount() << " misses\n";
+    }
+    return failed ? 1 : 0;
+}
+
+// Sample reviews for the benchmarks
+std::vector<std::string> makeBenchmarkTexts(size_t count) {
+    const char* samples[] = {
+        "The product arrived on time and works exactly as described.",
+        "Terrible support, I waited two weeks and nobody answered.",
+        "It is okay, nothing special but it does the job.",
+        "Absolutely love it, would buy again!",
+        "The battery died after three days, very disappointed."
+    };
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < count; ++i) {
+        texts.push_back(samples[i % 5] + std::string(" #") + std::to_string(i));
+    }
+    return texts;
+}
+
+// Tokenizer benchmark: tokens/sec encoding into one reusable row, as the predictors do
+int runTokenizerBenchmark(const std::string& vocabPath) {
+    WordPieceTokenizer tokenizer(vocabPath);
+    std::vector<std::string> texts = makeBenchmarkTexts(200000);
+    std::vector<int32_t> row(128);
+
+    size_t tokens = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& text : texts) tokens += tokenizer.encode(text, row.data(), static_cast<int>(row.size()));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "vocabulary: " << tokenizer.size() << " tokens\n";
+    std::cout << texts.size() << " texts, " << tokens << " tokens in " << seconds * 1000 << " ms ("
+              << static_cast<size_t>(tokens / seconds) << " tokens/sec, "
+              << static_cast<size_t>(texts.size() / seconds) << " texts/sec)\n";
+    return 0;
+}
+
+#ifndef SENTIMENT_NO_TFLITE
+// Throughput benchmark: texts/sec for different batch sizes and thread counts
+int runThroughputBenchmark(const std::string& modelPath, const std::string& vocabPath) {
+    auto model = loadModel(modelPath);
+    auto tokenizer = std::make_shared<const WordPieceTokenizer>(vocabPath);
+    std::vector<std::string> texts = makeBenchmarkTexts(20000);
+
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "threads  batch  texts/sec\n";
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        for (size_t batch : {1, 8, 32, 128}) {
+            SentimentEngine engine(model, tokenizer, threads, batch);
+            engine.predictBatch(std::vector<std::string>(texts.begin(), texts.begin() + 256));  // Warm up
+
+            auto start = std::chrono::steady_clock::now();
+            engine.predictBatch(texts);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << threads << "\t " << batch << "\t" << static_cast<size_t>(texts.size() / seconds) << "\n";
+        }
+    }
+
+    // Same stream where only every fourth text is new, the rest repeat earlier ones with different case/spacing
+    std::vector<std::string> repeated;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        std::string text = texts[(i / 4) * 4];
+        if (i % 4 == 1) std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+        if (i % 4 == 2) text = "  " + text + " ";
+        repeated.push_back(std::move(text));
+    }
+    for (bool cached : {false, true}) {
+        auto cache = cached ? std::make_shared<PredictionCache>(16u << 20) : nullptr;
+        SentimentEngine engine(model, tokenizer, maxThreads, 32, cache);
+
+        auto start = std::chrono::steady_clock::now();
+        engine.predictBatch(repeated);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << (cached ? "with cache:    " : "without cache: ") << static_cast<size_t>(repeated.size() / seconds)
+                  << " texts/sec";
+        if (cache) std::cout << " (" << cache->hitCount() << " hits, " << cache->missCount() << " misses)";
+        std::cout << "\n";
+    }
+    return 0;
+}
+#endif  // SENTIMENT_NO_TFLITE
+
+// Trains the n-gram fallback model from a labeled file and saves it
+int runTraining(const std::string& trainPath, const std::string& outPath, int epochs) {
+    std::vector<NGramClassifier::Example> examples = NGramClassifier::readLabeled(trainPath);
+    NGramClassifier model;
+
+    auto start = std::chrono::steady_clock::now();
+    model.train(examples, epochs, 0.5f);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t correct = 0;
+    for (const auto& example : examples) correct += model.predict(example.text) == example.label;
+    model.save(outPath);
+    std::cout << "trained on " << examples.size() << " texts (" << epochs << " epochs) in " << seconds * 1000
+              << " ms, training accuracy " << 100.0 * correct / std::max<size_t>(1, examples.size()) << "%\n";
+    std::cout << "saved " << outPath << "\n";
+    return 0;
+}
+
+// Accuracy and speed of any model (.tflite or n-gram) on a labeled test set, classified on one thread
+int runEvaluation(const std::string& modelPath, const std::string& testPath, const std::string& vocabPath) {
+    std::vector<NGramClassifier::Example> examples = NGramClassifier::readLabeled(testPath);
+    std::vector<std::string> texts;
+    for (const auto& example : examples) texts.push_back(example.text);
+    std::vector<int> labels(texts.size());
+
+    auto classifier = std::move(createClassifiers(modelPath, vocabPath, 1, nullptr).front());
+    const size_t batch = 32;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t begin = 0; begin < texts.size(); begin += batch) {
+        classifier->predict(&texts[begin], std::min(batch, texts.size() - begin), &labels[begin]);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t correct = 0;
+    for (size_t i = 0; i < examples.size(); ++i) correct += labels[i] == examples[i].label;
+    size_t count = std::max<size_t>(1, examples.size());
+    std::cout << modelPath << " on " << testPath << ": accuracy " << 100.0 * correct / count << "% ("
+              << correct << "/" << examples.size() << "), " << seconds * 1e6 / count << " us/text, "
+              << static_cast<size_t>(examples.size() / seconds) << " texts/sec\n";
+    return 0;
 }
 
 // wxWidgets Application: Sentiment Analysis App
@@ -59,27 +1085,29 @@ public:
 
 class SentimentFrame : public wxFrame {
 public:
-    SentimentFrame(const wxString& title);
+    SentimentFrame(const wxString& title, std::vector<std::unique_ptr<TextClassifier>> classifiers);
 
 private:
     void OnAnalyzeSentiment(wxCommandEvent& event);
-    
+
     wxTextCtrl* inputTextCtrl;
     wxStaticText* resultTextCtrl;
-    std::unique_ptr<tflite::Interpreter> interpreter;
+    // Declared last so it is destroyed first: its workers stop before the controls go away
+    std::unique_ptr<SentimentService> service;
 };
 
 bool SentimentApp::OnInit() {
-    // Load TensorFlow Lite model
-    interpreter = loadModel("text_classification.tflite");
+    // Load the TensorFlow Lite model (or the n-gram model in builds without TFLite)
+    auto classifiers = createClassifiers(kDefaultModelPath, "vocab.txt", 1, std::make_shared<PredictionCache>(1u << 20));
 
-    SentimentFrame* frame = new SentimentFrame("Sentiment Analysis");
+    SentimentFrame* frame = new SentimentFrame("Sentiment Analysis", std::move(classifiers));
     frame->Show(true);
     return true;
 }
 
-SentimentFrame::SentimentFrame(const wxString& title)
-    : wxFrame(NULL, wxID_ANY, title, wxDefaultPosition, wxSize(400, 300)) {
+SentimentFrame::SentimentFrame(const wxString& title, std::vector<std::unique_ptr<TextClassifier>> classifiers)
+    : wxFrame(NULL, wxID_ANY, title, wxDefaultPosition, wxSize(400, 300)),
+      service(std::make_unique<SentimentService>(std::move(classifiers), 8, 64)) {
 
     // Create GUI elements
     wxPanel* panel = new wxPanel(this, wxID_ANY);
@@ -100,8 +1128,53 @@ SentimentFrame::SentimentFrame(const wxString& title)
 
 void SentimentFrame::OnAnalyzeSentiment(wxCommandEvent& event) {
     std::string userText = inputTextCtrl->GetValue().ToStdString();
-    std::string sentiment = predictSentiment(interpreter.get(), userText);
-    resultTextCtrl->SetLabel("Predicted Sentiment: " + wxString(sentiment));
+    resultTextCtrl->SetLabel("Predicted Sentiment: ...");
+
+    // Inference runs on the service's worker; CallAfter brings the result back to the UI thread
+    service->submit(std::move(userText), [this](std::future<int> result) {
+        wxString text;
+        try {
+            text = "Predicted Sentiment: " + wxString(sentimentLabel(result.get()));
+        } catch (const std::exception& e) {
+            text = "Error: " + wxString(e.what());
+        }
+        CallAfter([this, text] {
+            resultTextCtrl->SetLabel(text);
+        });
+    });
 }
 
-wxIMPLEMENT_APP(SentimentApp);
+wxIMPLEMENT_APP_NO_MAIN(SentimentApp);
+
+// Usage: Ai-powered                                            (GUI)
+//        Ai-powered --classify [file|-] [model] [vocab]        (headless: one label per input line, no display needed)
+//        Ai-powered --train-fallback [train.tsv] [out] [epochs] (train the n-gram fallback model)
+//        Ai-powered --eval [model] [test.tsv] [vocab]          (accuracy and speed on a labeled test set)
+//        Ai-powered --bench [model] [vocab]                    (TFLite throughput benchmark)
+//        Ai-powered --bench-tokenizer [vocab]                  (tokenizer benchmark)
+// A model path not ending in .tflite is loaded as an n-gram model. Labeled files hold "label<TAB>text" lines;
+// sentiment_train.tsv and sentiment_test.tsv next to this file are a small bundled set.
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "--classify") {
+        return runHeadless(argc > 2 ? argv[2] : "-", argc > 3 ? argv[3] : kDefaultModelPath,
+                           argc > 4 ? argv[4] : "vocab.txt");
+    }
+    if (mode == "--train-fallback") {
+        return runTraining(argc > 2 ? argv[2] : "sentiment_train.tsv", argc > 3 ? argv[3] : "sentiment.ngram",
+                           argc > 4 ? std::stoi(argv[4]) : 10);
+    }
+    if (mode == "--eval") {
+        return runEvaluation(argc > 2 ? argv[2] : "sentiment.ngram", argc > 3 ? argv[3] : "sentiment_test.tsv",
+                             argc > 4 ? argv[4] : "vocab.txt");
+    }
+#ifndef SENTIMENT_NO_TFLITE
+    if (mode == "--bench") {
+        return runThroughputBenchmark(argc > 2 ? argv[2] : kDefaultModelPath, argc > 3 ? argv[3] : "vocab.txt");
+    }
+#endif
+    if (mode == "--bench-tokenizer") {
+        return runTokenizerBenchmark(argc > 2 ? argv[2] : "vocab.txt");
+    }
+    return wxEntry(argc, argv);
+}